@@ -0,0 +1,144 @@
+// banglish_client: sends a Banglish program to banglishd and prints the result like the driver would.
+// With --load=N it doubles as a load generator: N requests over --concurrency connections, reporting
+// throughput and latency percentiles.
+#include "compiler/std.h"
+#include "compiler/server_protocol.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+using namespace std;
+
+#ifdef _WIN32
+int main() {
+    cerr << "Error: banglish_client needs Unix domain sockets\n";
+    return 1;
+}
+#else
+
+struct ClientOptions {
+    string socketPath = defaultSocketPath();
+    string mode = "run";        // --mode=check|run|native
+    string sourceFile = "main.banglish";
+    string inputFile = "input.txt";
+    bool arena = false;
+    bool fused = false;
+    size_t load = 0;            // --load=N: send N requests and report latency instead of printing results
+    size_t concurrency = 4;
+};
+
+string readFileOrEmpty(const string& path) {
+    ifstream file(path, ios::binary);
+    return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+}
+
+// Prints diagnostics and program output; the exit status follows the program's, or 2 when it never ran
+int printResult(const Message& response) {
+    auto field = [&](const char* name) { auto it = response.find(name); return it == response.end() ? string() : it->second; };
+    if (field("status") != "ok") {
+        cerr << "Error: " << field("message") << "\n" << field("compiler-output");
+        return 2;
+    }
+    size_t errors = stoul("0" + field("error-count")), warnings = stoul("0" + field("warning-count"));
+    if (errors) cerr << "Compilation failed with " << errors << " error(s)" << (warnings ? " and " + to_string(warnings) + " improvement(s)" : "") << ".\n";
+    else if (warnings) cout << "Compilation successful with " << warnings << " improvement(s).\n";
+    else cout << "Compilation successful with no errors or improvements.\n";
+    if (!field("note").empty()) cerr << "Note: " << field("note") << "\n";
+    if (!response.count("exit-code")) return 0;
+    cout << field("output");
+    cout.flush();
+    cerr << "\n[" << field("tier") << (field("cached") == "1" ? ", cached build" : "") << ", " << field("server-ms") << " ms on the server]\n";
+    return atoi(field("exit-code").c_str());
+}
+
+// Issues options.load requests over options.concurrency connections; prints req/s and latency percentiles
+int runLoad(const ClientOptions& options, const Message& request) {
+    vector<double> latencies(options.load);
+    atomic<size_t> next{0}, answered{0}, lost{0}, rejected{0};
+    auto start = chrono::steady_clock::now();
+    vector<thread> clients;
+    for (size_t c = 0; c < min(options.concurrency, options.load); ++c) {
+        clients.emplace_back([&] {
+            int fd = connectSocket(options.socketPath);
+            if (fd < 0) return;  // The other connections take its share
+            SocketReader reader(fd);
+            Message response;
+            for (size_t i; (i = next++) < options.load; ) {
+                auto sent = chrono::steady_clock::now();
+                // A broken connection fails the request in flight; the remaining ones go to the other connections
+                if (!writeMessage(fd, request) || !readMessage(reader, response)) { lost += 1; break; }
+                latencies[i] = chrono::duration<double, milli>(chrono::steady_clock::now() - sent).count();
+                answered += 1;
+                if (response["status"] != "ok") rejected += 1;
+            }
+            close(fd);
+        });
+    }
+    for (auto& client : clients) client.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t unsent = options.load - answered - lost;  // No connection was left to send them
+    if (lost || rejected || unsent) {
+        cerr << "Error: " << lost + rejected << " of " << options.load << " request(s) failed";
+        if (unsent) cerr << ", " << unsent << " not sent (no connection left)";
+        cerr << "\n";
+        return 2;
+    }
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[min(latencies.size() - 1, (size_t)(p * latencies.size()))]; };
+    cout << fixed << setprecision(2)
+         << "requests: " << options.load << ", concurrency: " << options.concurrency << ", mode: " << options.mode << "\n"
+         << "throughput: " << options.load / seconds << " req/s over " << seconds << " s\n"
+         << "latency ms: p50 " << percentile(0.50) << ", p90 " << percentile(0.90) << ", p99 " << percentile(0.99)
+         << ", max " << latencies.back() << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    ClientOptions options;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--socket=", 0) == 0) options.socketPath = arg.substr(9);
+        else if (arg == "--mode=check" || arg == "--mode=run" || arg == "--mode=native") options.mode = arg.substr(7);
+        else if (arg == "--arena") options.arena = true;
+        else if (arg == "--fused") options.fused = true;
+        else if (arg.rfind("--load=", 0) == 0) options.load = max(1, atoi(arg.c_str() + 7));
+        else if (arg.rfind("--concurrency=", 0) == 0) options.concurrency = max(1, atoi(arg.c_str() + 14));
+        else if (arg.rfind("--", 0) != 0 && files.size() < 2) files.push_back(arg);
+        else {
+            cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (files.size() > 0) options.sourceFile = files[0];
+    if (files.size() > 1) options.inputFile = files[1];
+
+    ifstream source(options.sourceFile, ios::binary);
+    if (!source) {
+        cerr << "Error: Cannot open " << options.sourceFile << "\n";
+        return 1;
+    }
+    Message request;
+    request["mode"] = options.mode;
+    request["source"] = string((istreambuf_iterator<char>(source)), istreambuf_iterator<char>());
+    request["input"] = readFileOrEmpty(options.inputFile);
+    if (options.arena) request["arena"] = "1";
+    if (options.fused) request["fused"] = "1";
+
+    if (options.load) return runLoad(options, request);
+    int fd = connectSocket(options.socketPath);
+    if (fd < 0) {
+        cerr << "Error: no banglishd listening on " << options.socketPath << "\n";
+        return 1;
+    }
+    SocketReader reader(fd);
+    Message response;
+    bool ok = writeMessage(fd, request) && readMessage(reader, response);
+    close(fd);
+    if (!ok) {
+        cerr << "Error: connection to banglishd lost\n";
+        return 1;
+    }
+    return printResult(response);
+}
+#endif
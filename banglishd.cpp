@@ -0,0 +1,342 @@
+// banglishd: long-lived Banglish compile server on a Unix domain socket. Requests run concurrently on a
+// worker pool; the compiled regex tables, a precompiled header for the generated C++ and a cache of built
+// programs stay warm between requests. Talk to it with banglish_client.
+#include "compiler/std.h"
+#include "compiler/content_hash.h"
+#include "compiler/library.h"
+#include "compiler/server_protocol.h"
+#include "compiler/thread_pool.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+#ifdef _WIN32
+int main() {
+    cerr << "Error: banglishd needs Unix domain sockets\n";
+    return 1;
+}
+#else
+
+// Includes every transpiled program starts with; compiled once into a .gch that g++ picks up with -include
+static const char* PCH_SOURCE = "#include <iostream>\n#include <string>\n#include <vector>\n#include <sstream>\n"
+                                "#include <iomanip>\n#include <unordered_map>\n#include <set>\n";
+static const string CXX_FLAGS = "g++ -std=c++17 -O2";
+
+struct ServerOptions {
+    string socketPath = defaultSocketPath();
+    string cacheDir = ".generated/banglishd";
+    unsigned jobs = max(1u, thread::hardware_concurrency());
+    unsigned runSeconds = 10;   // CPU and wall-clock limit for each natively run program
+};
+
+// A client connection and its read buffer; the socket is closed with the last reference, whichever path drops it
+struct Connection {
+    int fd;
+    SocketReader reader;
+    explicit Connection(int socket) : fd(socket), reader(socket) {}
+    ~Connection() { close(fd); }
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+};
+
+static string socketToRemove;
+static void shutdownServer(int) {
+    if (!socketToRemove.empty()) unlink(socketToRemove.c_str());
+    _exit(0);
+}
+
+class Server {
+private:
+    ServerOptions options;
+    string pchHeader;
+    atomic<unsigned long long> nextTemp{0};
+    // Connections whose request was answered, waiting to be polled again; wakeFd[1] tells the poller
+    mutex answeredMutex;
+    vector<shared_ptr<Connection>> answered;
+    int wakeFd[2] = {-1, -1};
+
+    static string readFile(const string& path) {
+        ifstream file(path, ios::binary);
+        return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    }
+    string tempPath(const string& suffix) {
+        return options.cacheDir + "/tmp/" + to_string(getpid()) + "-" + to_string(nextTemp++) + suffix;
+    }
+
+    // Builds (or reuses) the binary for generated C++; the cache is keyed by the code itself
+    bool buildNative(const string& cpp, string& binary, bool& cached, string& diagnostics) {
+        binary = options.cacheDir + "/bin/" + bg::hexName(bg::fnv1a(cpp));
+        cached = ifstream(binary).good();
+        if (cached) return true;
+        string source = tempPath(".cpp"), output = tempPath(""), log = tempPath(".log");
+        ofstream(source, ios::binary) << cpp;
+        string include = pchHeader.empty() ? "" : " -include \"" + pchHeader + "\"";
+        string command = CXX_FLAGS + include + " -o \"" + output + "\" \"" + source + "\" 2> \"" + log + "\"";
+        bool ok = system(command.c_str()) == 0;
+        diagnostics = readFile(log);
+        remove(source.c_str());
+        remove(log.c_str());
+        // Concurrent builds of the same program race harmlessly: rename() replaces the file atomically
+        if (ok) ok = rename(output.c_str(), binary.c_str()) == 0;
+        return ok;
+    }
+
+    // Runs a built program under RLIMIT_CPU and kills it once it outlives the same limit in wall time,
+    // so a program that loops or blocks cannot keep a worker (or a CPU) busy after the client gave up
+    void runNative(const string& binary, const string& input, Message& response) {
+        string in = tempPath(".in"), out = tempPath(".out");
+        ofstream(in, ios::binary) << input;
+        int inFd = open(in.c_str(), O_RDONLY | O_CLOEXEC);
+        int outFd = open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        pid_t pid = inFd >= 0 && outFd >= 0 ? fork() : -1;
+        if (pid == 0) {
+            dup2(inFd, 0);
+            dup2(outFd, 1);
+            rlimit limit{options.runSeconds, options.runSeconds + 1};
+            setrlimit(RLIMIT_CPU, &limit);
+            execl(binary.c_str(), binary.c_str(), (char*)nullptr);
+            _exit(127);
+        }
+        if (inFd >= 0) close(inFd);
+        if (outFd >= 0) close(outFd);
+        int status = 0;
+        bool killed = false;
+        if (pid > 0) {
+            auto deadline = chrono::steady_clock::now() + chrono::seconds(options.runSeconds);
+            auto pause = chrono::microseconds(100);
+            while (true) {
+                pid_t done = waitpid(pid, &status, WNOHANG);
+                if (done == pid || (done < 0 && errno != EINTR)) break;
+                if (chrono::steady_clock::now() >= deadline) {
+                    kill(pid, SIGKILL);
+                    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+                    killed = true;
+                    break;
+                }
+                this_thread::sleep_for(pause);
+                pause = min(pause * 2, chrono::microseconds(10000));
+            }
+        }
+        response["output"] = readFile(out);
+        remove(in.c_str());
+        remove(out.c_str());
+        if (pid < 0) {
+            response["status"] = "error";
+            response["message"] = "could not start the program";
+        } else if (killed || (WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU)) {
+            response["status"] = "error";
+            response["message"] = "program exceeded the time limit of " + to_string(options.runSeconds) + " s";
+        } else {
+            response["exit-code"] = to_string(WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status));
+        }
+    }
+
+public:
+    explicit Server(const ServerOptions& o) : options(o) {}
+
+    // Prepares the cache directories and precompiled header, and warms the front end's static tables
+    void warmUp() {
+        filesystem::create_directories(options.cacheDir + "/bin");
+        filesystem::create_directories(options.cacheDir + "/tmp");
+        string header = options.cacheDir + "/bg_pch.h";
+        ofstream(header) << PCH_SOURCE;
+        string command = CXX_FLAGS + " -x c++-header \"" + header + "\" -o \"" + header + ".gch\"";
+        if (system(command.c_str()) == 0) pchHeader = header;
+        else cerr << "banglishd: precompiled header failed to build, continuing without it\n";
+        bg::compile("shuru\nshesh\n");
+    }
+
+    // mode=check returns diagnostics and generated C++; run executes in process; native builds with g++
+    Message handle(const Message& request) {
+        auto start = chrono::steady_clock::now();
+        Message response;
+        auto field = [&](const char* name) { auto it = request.find(name); return it == request.end() ? string() : it->second; };
+        string mode = field("mode");
+        if (mode.empty()) mode = "run";
+        if (mode != "check" && mode != "run" && mode != "native") {
+            response["status"] = "error";
+            response["message"] = "unknown mode '" + mode + "'";
+            return response;
+        }
+        bg::CompileOptions compileOptions;
+        compileOptions.fused = field("fused") == "1";
+        compileOptions.useArena = field("arena") == "1";
+        compileOptions.execute = mode == "run";
+        compileOptions.input = field("input");
+        bg::CompileResult result = bg::compile(field("source"), compileOptions);
+
+        response["status"] = "ok";
+        response["error-count"] = to_string(result.errorCount);
+        response["warning-count"] = to_string(result.warningCount);
+        response["error-log"] = result.errorLog;
+        string validation;
+        for (const string& e : result.validation.tokenErrors) validation += e + "\n";
+        for (const string& e : result.validation.lineErrors) validation += e + "\n";
+        response["validation"] = result.validation.ok() ? "OK\n" : validation;
+        response["cpp"] = result.cpp;
+        if (mode == "run") {
+            if (result.execution.ran) {
+                response["output"] = result.execution.output;
+                response["exit-code"] = to_string(result.execution.exitCode);
+            } else if (result.execution.lowered) {
+                // Out of steps or undefined behaviour: a native build would only spin or fault without the checks
+                response["status"] = "error";
+                response["message"] = result.execution.error;
+                response["output"] = result.execution.output;
+            } else {
+                // Programs the interpreter cannot take are built and run natively instead
+                mode = "native";
+                response["note"] = result.execution.error;
+            }
+        }
+        if (mode == "native") {
+            string binary, diagnostics;
+            bool cached = false;
+            if (!buildNative(result.cpp, binary, cached, diagnostics)) {
+                response["status"] = "error";
+                response["message"] = "compilation of transpiled code failed";
+                response["compiler-output"] = diagnostics;
+            } else {
+                response["cached"] = cached ? "1" : "0";
+                runNative(binary, compileOptions.input, response);
+            }
+        }
+        response["tier"] = mode == "native" ? "native" : mode == "run" ? "interpreter" : "none";
+        ostringstream elapsed;
+        elapsed << fixed << setprecision(2) << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        response["server-ms"] = elapsed.str();
+        return response;
+    }
+
+    // Answers one request, then hands the connection back to the poller; a closed, malformed or
+    // timed-out connection is dropped here and closed by ~Connection. Reading the request and writing the
+    // response each get IO_SECONDS in total, so a client that trickles bytes cannot hold the worker.
+    void serveOne(shared_ptr<Connection> connection) {
+        static const auto IO_SECONDS = chrono::seconds(10);
+        Message request, response;
+        connection->reader.setDeadline(chrono::steady_clock::now() + IO_SECONDS);
+        if (!readMessage(connection->reader, request)) return;
+        try {
+            response = handle(request);
+        } catch (const exception& e) {
+            response = {{"status", "error"}, {"message", string("internal error: ") + e.what()}};
+        }
+        if (!writeMessage(connection->fd, response, chrono::steady_clock::now() + IO_SECONDS)) return;
+        {
+            lock_guard<mutex> lock(answeredMutex);
+            answered.push_back(move(connection));
+        }
+        char wake = 0;
+        (void)!write(wakeFd[1], &wake, 1);
+    }
+
+    int run() {
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (listener < 0 || options.socketPath.size() >= sizeof address.sun_path) {
+            cerr << "Error: cannot create socket " << options.socketPath << "\n";
+            return 1;
+        }
+        options.socketPath.copy(address.sun_path, options.socketPath.size());
+        int probe = connectSocket(options.socketPath);
+        if (probe >= 0) {
+            close(probe);
+            cerr << "Error: a server is already listening on " << options.socketPath << "\n";
+            return 1;
+        }
+        unlink(options.socketPath.c_str());
+        if (bind(listener, (sockaddr*)&address, sizeof address) != 0 || listen(listener, 128) != 0) {
+            cerr << "Error: cannot listen on " << options.socketPath << "\n";
+            return 1;
+        }
+        socketToRemove = options.socketPath;
+        signal(SIGINT, shutdownServer);
+        signal(SIGTERM, shutdownServer);
+        signal(SIGPIPE, SIG_IGN);
+
+        if (pipe(wakeFd) != 0) {
+            cerr << "Error: cannot create the wake-up pipe\n";
+            return 1;
+        }
+        for (int fd : {listener, wakeFd[0], wakeFd[1]}) fcntl(fd, F_SETFD, FD_CLOEXEC);
+        for (int fd : wakeFd) fcntl(fd, F_SETFL, O_NONBLOCK);
+
+        warmUp();
+        ThreadPool pool(options.jobs);
+        cout << "banglishd listening on " << options.socketPath << " with " << pool.size() << " worker(s)" << endl;
+        // Idle connections wait in poll() on this thread rather than on a worker, so any number of them can stay
+        // open; a readable one gets a task that answers a single request.
+        vector<shared_ptr<Connection>> idle;
+        auto dispatch = [&](shared_ptr<Connection> connection) { pool.submit([this, connection] { serveOne(connection); }); };
+        while (true) {
+            vector<pollfd> fds{{listener, POLLIN, 0}, {wakeFd[0], POLLIN, 0}};
+            for (auto& connection : idle) fds.push_back({connection->fd, POLLIN, 0});
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            vector<shared_ptr<Connection>> waiting;
+            for (size_t i = 0; i < idle.size(); ++i) {
+                if (fds[i + 2].revents) dispatch(move(idle[i]));
+                else waiting.push_back(move(idle[i]));
+            }
+            idle = move(waiting);
+            if (fds[1].revents) {
+                char drain[256];
+                while (read(wakeFd[0], drain, sizeof drain) > 0) {}
+                lock_guard<mutex> lock(answeredMutex);
+                // A client that pipelined its next request has it buffered already; poll() would not report it
+                for (auto& connection : answered) {
+                    if (connection->reader.buffered()) dispatch(move(connection));
+                    else idle.push_back(move(connection));
+                }
+                answered.clear();
+            }
+            if (fds[0].revents) {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd < 0) {
+                    if (errno == EMFILE || errno == ENFILE) this_thread::sleep_for(chrono::milliseconds(10));  // Until a connection closes
+                    else if (errno != EINTR && errno != ECONNABORTED) break;
+                    continue;
+                }
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+                idle.push_back(make_shared<Connection>(fd));
+            }
+        }
+        close(listener);
+        return 0;
+    }
+};
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--socket=", 0) == 0) options.socketPath = arg.substr(9);
+        else if (arg.rfind("--cache=", 0) == 0) options.cacheDir = arg.substr(8);
+        else if (arg.rfind("--jobs=", 0) == 0) options.jobs = max(1, atoi(arg.c_str() + 7));
+        else if (arg.rfind("--run-limit=", 0) == 0) options.runSeconds = max(1, atoi(arg.c_str() + 12));
+        else {
+            cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    return Server(options).run();
+}
+#endif
@@ -20,7 +20,7 @@ if ($clCmd) {
 else {
     $gppCmd = Get-Command g++ -ErrorAction SilentlyContinue
     if (-not $gppCmd) { throw 'No C++ compiler found. Install Visual Studio Build Tools (cl) or MinGW (g++).' }
-    & g++ -std=c++17 -O2 -o `"$outExe`" `"$driver`"
+    & g++ -std=c++17 -O2 -pthread -o `"$outExe`" `"$driver`"
 }
 
 if ($LASTEXITCODE -ne 0) { throw 'Compilation failed' }
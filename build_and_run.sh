@@ -12,7 +12,7 @@ mkdir -p .generated
 
 # Compile driver
 echo "Compiling driver..."
-if ! g++ -std=c++17 -O2 -o .generated/banglish_driver main.cpp; then
+if ! g++ -std=c++17 -O2 -pthread -o .generated/banglish_driver main.cpp; then
     echo "ERROR: Compilation failed"
     exit 1
 fi
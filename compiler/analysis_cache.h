@@ -0,0 +1,264 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "content_hash.h"
+#include "token.h"
+#include "parser.h"
+#include "symbol_table.h"
+#include "validator.h"
+
+// .generated/main.bgc: everything the front end found in one source (tokens, diagnostics, validation
+// findings, symbols) in a fixed layout that is used straight from a read-only mapping. Records refer
+// to one interned string table by offset, so nothing is parsed or allocated to load it; reports are
+// only rebuilt from it when one has to be written again.
+namespace bg {
+
+static const uint32_t BGC_VERSION = 2;
+
+struct BgcString { uint32_t offset, size; };
+struct BgcToken { BgcString type, lexeme; int32_t line, col; };
+struct BgcDiagnostic { BgcString type, message, context; int32_t line, col; uint64_t repeats; };
+struct BgcSuppressed { BgcString type; uint32_t isError, unused; uint64_t count; };  // Per type, past the logger's limit
+struct BgcSymbol { BgcString name, dtype, value, arraySize; int32_t line; uint8_t initialized, isArray, unused[2]; };
+
+struct BgcHeader {
+    char magic[4];              // "BGC\0"
+    uint32_t version;           // BGC_VERSION
+    uint32_t byteOrder;         // 0x01020304 as written by this machine
+    uint32_t unused;
+    uint64_t buildStamp;        // Hash of the driver's build time: a rebuilt driver may analyze differently
+    uint64_t sourceHash, sourceSize, fileSize;
+    uint64_t tokensAt, errorsAt, warningsAt, suppressedAt, findingsAt, symbolsAt, stringsAt;  // Byte offsets into the file
+    uint64_t errorTotal, warningTotal;  // Diagnostics found, including repeats and suppressed ones
+    uint32_t tokenCount, errorCount, warningCount, suppressedCount, tokenFindingCount, lineFindingCount, symbolCount;
+};
+
+inline uint64_t bgcBuildStamp(){ return fnv1a(__DATE__ " " __TIME__); }
+
+// Builds the file image in memory; each distinct string is stored once. The interning table points
+// into the arguments, which must outlive the writer.
+class AnalysisCacheWriter {
+private:
+    std::string strings;
+    std::unordered_map<std::string_view, BgcString> interned;
+    std::vector<BgcToken> tokens;
+    std::vector<BgcDiagnostic> errors, warnings;
+    std::vector<BgcSuppressed> suppressed;
+    uint64_t errorTotal = 0, warningTotal = 0;
+    std::vector<BgcString> findings;
+    std::vector<BgcSymbol> symbols;
+    uint32_t tokenFindings = 0;
+
+    BgcString intern(std::string_view s){
+        auto it = interned.find(s);
+        if(it != interned.end()) return it->second;
+        BgcString ref{(uint32_t)strings.size(), (uint32_t)s.size()};
+        strings += s;
+        return interned.emplace(s, ref).first->second;
+    }
+    std::vector<BgcDiagnostic> diagnostics(const std::vector<ParseError>& list){
+        std::vector<BgcDiagnostic> out;
+        for(const ParseError& e: list) out.push_back({intern(e.type), intern(e.message), intern(e.context), e.line, e.col, e.repeats});
+        return out;
+    }
+    template<class T> static void put(std::string& image, uint64_t& at, const std::vector<T>& items){
+        image.resize((image.size() + 7) & ~size_t(7));
+        at = image.size();
+        if(!items.empty()) image.append((const char*)items.data(), items.size() * sizeof(T));
+    }
+public:
+    AnalysisCacheWriter(const std::vector<Token>& toks, const ErrorLogger& log, const ValidationReport& report, const std::vector<Symbol>& syms){
+        tokens.reserve(toks.size());
+        interned.reserve(toks.size() / 4);
+        for(const Token& t: toks) tokens.push_back({intern(t.type), intern(t.lexeme), t.line, t.col});
+        errors = diagnostics(log.getErrors());
+        warnings = diagnostics(log.getWarnings());
+        for(const auto& entry: log.getSuppressedErrors()) suppressed.push_back({intern(entry.first), 1, 0, entry.second});
+        for(const auto& entry: log.getSuppressedWarnings()) suppressed.push_back({intern(entry.first), 0, 0, entry.second});
+        errorTotal = log.getErrorCount();
+        warningTotal = log.getWarningCount();
+        for(const std::string& f: report.tokenErrors) findings.push_back(intern(f));
+        tokenFindings = (uint32_t)findings.size();
+        for(const std::string& f: report.lineErrors) findings.push_back(intern(f));
+        for(const Symbol& s: syms) symbols.push_back({intern(s.name), intern(s.dtype), intern(s.value), intern(s.arraySize), s.line, s.initialized, s.isArray, {0, 0}});
+    }
+    // Writes next to `path` and renames over it, so a reader never maps a half-written file
+    bool write(const std::string& path, std::string_view source) const {
+        BgcHeader h{};
+        std::memcpy(h.magic, "BGC", 4);
+        h.version = BGC_VERSION;
+        h.byteOrder = 0x01020304;
+        h.buildStamp = bgcBuildStamp();
+        h.sourceHash = fnv1a(source);
+        h.sourceSize = source.size();
+        h.tokenCount = (uint32_t)tokens.size();
+        h.errorCount = (uint32_t)errors.size();
+        h.warningCount = (uint32_t)warnings.size();
+        h.suppressedCount = (uint32_t)suppressed.size();
+        h.errorTotal = errorTotal;
+        h.warningTotal = warningTotal;
+        h.tokenFindingCount = tokenFindings;
+        h.lineFindingCount = (uint32_t)(findings.size() - tokenFindings);
+        h.symbolCount = (uint32_t)symbols.size();
+        std::string image(sizeof h, '\0');
+        put(image, h.tokensAt, tokens);
+        put(image, h.errorsAt, errors);
+        put(image, h.warningsAt, warnings);
+        put(image, h.suppressedAt, suppressed);
+        put(image, h.findingsAt, findings);
+        put(image, h.symbolsAt, symbols);
+        h.stringsAt = image.size();
+        image += strings;
+        h.fileSize = image.size();
+        std::memcpy(&image[0], &h, sizeof h);
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary);
+            if(!file.write(image.data(), image.size())) return false;
+        }
+        std::remove(path.c_str());
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+};
+
+// Read-only view of a main.bgc that matches the current source and driver build
+class AnalysisCache {
+private:
+    const char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    std::string buffer;
+#endif
+    const BgcHeader& header() const { return *(const BgcHeader*)base; }
+    template<class T> const T* array(uint64_t at) const { return (const T*)(base + at); }
+    template<class T> bool fits(uint64_t at, uint64_t count) const {
+        return at % alignof(T) == 0 && at <= size && count <= (size - at) / sizeof(T);
+    }
+    void unmap(){
+#ifndef _WIN32
+        if(base) munmap((void*)base, size);
+#endif
+        base = nullptr; size = 0;
+    }
+    // Every offset and count is checked once here so the accessors can index without checks
+    bool consistent(std::string_view source) const {
+        if(size < sizeof(BgcHeader)) return false;
+        const BgcHeader& h = header();
+        if(std::memcmp(h.magic, "BGC", 4) != 0 || h.version != BGC_VERSION || h.byteOrder != 0x01020304) return false;
+        if(h.buildStamp != bgcBuildStamp() || h.fileSize != size || h.sourceSize != source.size() || h.sourceHash != fnv1a(source)) return false;
+        if(!fits<BgcToken>(h.tokensAt, h.tokenCount) || !fits<BgcDiagnostic>(h.errorsAt, h.errorCount) ||
+           !fits<BgcDiagnostic>(h.warningsAt, h.warningCount) || !fits<BgcSuppressed>(h.suppressedAt, h.suppressedCount) ||
+           !fits<BgcSymbol>(h.symbolsAt, h.symbolCount) ||
+           !fits<BgcString>(h.findingsAt, (uint64_t)h.tokenFindingCount + h.lineFindingCount) || h.stringsAt > size) return false;
+        uint64_t stringBytes = size - h.stringsAt;
+        auto inTable = [&](BgcString s){ return s.offset <= stringBytes && s.size <= stringBytes - s.offset; };
+        for(uint32_t k=0;k<h.tokenCount;++k) if(!inTable(tokenAt(k).type) || !inTable(tokenAt(k).lexeme)) return false;
+        auto diagnosticsOk = [&](uint64_t at, uint32_t count){
+            const BgcDiagnostic* list = array<BgcDiagnostic>(at);
+            for(uint32_t k=0;k<count;++k) if(!inTable(list[k].type) || !inTable(list[k].message) || !inTable(list[k].context)) return false;
+            return true;
+        };
+        if(!diagnosticsOk(h.errorsAt, h.errorCount) || !diagnosticsOk(h.warningsAt, h.warningCount)) return false;
+        for(uint32_t k=0;k<h.suppressedCount;++k) if(!inTable(array<BgcSuppressed>(h.suppressedAt)[k].type)) return false;
+        for(uint32_t k=0;k<h.tokenFindingCount+h.lineFindingCount;++k) if(!inTable(array<BgcString>(h.findingsAt)[k])) return false;
+        for(uint32_t k=0;k<h.symbolCount;++k){
+            const BgcSymbol& s = array<BgcSymbol>(h.symbolsAt)[k];
+            if(!inTable(s.name) || !inTable(s.dtype) || !inTable(s.value) || !inTable(s.arraySize)) return false;
+        }
+        return true;
+    }
+public:
+    AnalysisCache() = default;
+    AnalysisCache(const AnalysisCache&) = delete;
+    AnalysisCache& operator=(const AnalysisCache&) = delete;
+    ~AnalysisCache(){ unmap(); }
+
+    // Maps `path`; false (and nothing loaded) when it is missing, damaged or made for another source
+    bool open(const std::string& path, std::string_view source){
+        unmap();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0) return false;
+        struct stat st;
+        if(fstat(fd, &st) == 0 && st.st_size > 0){
+            void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped != MAP_FAILED){ base = (const char*)mapped; size = (size_t)st.st_size; }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        base = buffer.data(); size = buffer.size();
+#endif
+        if(base && consistent(source)) return true;
+        unmap();
+        return false;
+    }
+    bool loaded() const { return base != nullptr; }
+
+    std::string_view str(BgcString s) const { return std::string_view(base + header().stringsAt + s.offset, s.size); }
+    uint32_t tokenCount() const { return header().tokenCount; }
+    const BgcToken& tokenAt(uint32_t k) const { return array<BgcToken>(header().tokensAt)[k]; }
+    size_t errorCount() const { return header().errorTotal; }
+    size_t warningCount() const { return header().warningTotal; }
+
+    // Owning copies, built only for the phases and reports that need them
+    std::vector<Token> tokens() const {
+        std::vector<Token> out;
+        out.reserve(tokenCount());
+        for(uint32_t k=0;k<tokenCount();++k){
+            const BgcToken& t = tokenAt(k);
+            out.push_back({std::string(str(t.type)), std::string(str(t.lexeme)), t.line, t.col});
+        }
+        return out;
+    }
+    ErrorLogger diagnostics(const std::string& logFile) const {
+        ErrorLogger log(logFile);
+        auto restore = [&](bool isError, uint64_t at, uint32_t count){
+            const BgcDiagnostic* list = array<BgcDiagnostic>(at);
+            for(uint32_t k=0;k<count;++k){
+                const BgcDiagnostic& e = list[k];
+                ParseError entry(e.line, e.col, ErrorLogger::shared(str(e.type)), std::string(str(e.message)), ErrorLogger::shared(str(e.context)));
+                entry.repeats = e.repeats;
+                log.restore(isError, std::move(entry));
+            }
+        };
+        restore(true, header().errorsAt, header().errorCount);
+        restore(false, header().warningsAt, header().warningCount);
+        const BgcSuppressed* suppressed = array<BgcSuppressed>(header().suppressedAt);
+        for(uint32_t k=0;k<header().suppressedCount;++k){
+            log.restoreSuppressed(suppressed[k].isError != 0, ErrorLogger::shared(str(suppressed[k].type)), suppressed[k].count);
+        }
+        return log;
+    }
+    ValidationReport validation() const {
+        ValidationReport report;
+        const BgcString* list = array<BgcString>(header().findingsAt);
+        for(uint32_t k=0;k<header().tokenFindingCount;++k) report.tokenErrors.emplace_back(str(list[k]));
+        for(uint32_t k=0;k<header().lineFindingCount;++k) report.lineErrors.emplace_back(str(list[header().tokenFindingCount + k]));
+        return report;
+    }
+    std::vector<Symbol> symbols() const {
+        std::vector<Symbol> out;
+        for(uint32_t k=0;k<header().symbolCount;++k){
+            const BgcSymbol& s = array<BgcSymbol>(header().symbolsAt)[k];
+            out.push_back({std::string(str(s.name)), std::string(str(s.dtype)), s.line, s.initialized != 0,
+                           std::string(str(s.value)), s.isArray != 0, std::string(str(s.arraySize))});
+        }
+        return out;
+    }
+};
+
+}
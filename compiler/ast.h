@@ -0,0 +1,543 @@
+#pragma once
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "token.h"
+#include "lexer.h"
+#include "compilation_unit.h"
+
+// Typed syntax tree for the backends that do not go through line-based C++ text
+// (native assembly, C, the interpreter). The C++ transpiler keeps working on lines.
+
+enum class ValueType { Int, Double, Char, Bool, String, Void };
+
+inline const char* valueTypeName(ValueType t){
+    switch(t){
+        case ValueType::Int: return "int";
+        case ValueType::Double: return "double";
+        case ValueType::Char: return "char";
+        case ValueType::Bool: return "bool";
+        case ValueType::String: return "string";
+        default: return "void";
+    }
+}
+
+// Raised for programs the tree cannot represent; callers fall back to the C++ transpiler
+struct LoweringError : std::runtime_error {
+    int line;
+    LoweringError(int l, const std::string& msg) : std::runtime_error("line " + std::to_string(l) + ": " + msg), line(l) {}
+};
+
+struct VarInfo {
+    std::string name;
+    ValueType type;
+    bool isArray;
+    int id;     // Dense index over every declaration in the program
+    int line;
+};
+
+struct Expr;
+struct Stmt;
+using ExprPtr = std::unique_ptr<Expr>;
+using StmtPtr = std::unique_ptr<Stmt>;
+
+struct Expr {
+    enum Kind { Number, Real, Text, Character, Boolean, Variable, Index, Unary, Binary, Logical, Assign, Step, Cast };
+    Kind kind;
+    int line = 0;
+    std::string op;             // Operator spelling; variable name for Variable/Index
+    long long intValue = 0;     // Number, Character, Boolean
+    double realValue = 0;       // Real
+    std::string text;           // Text (escapes already applied)
+    bool postfix = false;       // Step: i++ rather than ++i
+    ValueType castTo = ValueType::Void;
+    std::vector<ExprPtr> args;  // Operands; Index: {subscript}; Assign/Step: {target, value}
+    VarInfo* var = nullptr;     // Resolved declaration for Variable/Index
+    ValueType type = ValueType::Void;
+};
+
+struct PrintPart {
+    bool isText;
+    std::string text;
+    ExprPtr expr;
+};
+
+struct Stmt {
+    enum Kind { Declare, Read, Print, If, Loop, Return, Eval, Block };
+    Kind kind;
+    int line = 0;
+    VarInfo* var = nullptr;             // Declare
+    ExprPtr size;                       // Declare (arrays)
+    ExprPtr init;                       // Declare
+    std::vector<ExprPtr> initList;      // Declare: `= {a, b, c}` for arrays
+    ExprPtr target;                     // Read
+    std::vector<PrintPart> parts;       // Print
+    ExprPtr cond;                       // If, Loop
+    StmtPtr then, otherwise;            // If
+    StmtPtr start; ExprPtr step;        // Loop: `loop (start; cond; step) then`
+    ExprPtr value;                      // Return, Eval
+    std::vector<StmtPtr> body;          // Block
+    bool scoped = true;                 // Block: false for `purno sonkha a, b;` groups
+};
+
+struct Program {
+    std::vector<StmtPtr> body;
+    std::vector<std::unique_ptr<VarInfo>> vars;
+    int lastLine = 1;
+};
+
+// Applies C/C++ escape sequences the way g++ does for "..." and '...' literals
+inline std::string unescapeLiteral(const std::string& raw){
+    std::string out;
+    for(size_t i=0;i<raw.size();++i){
+        char c = raw[i];
+        if(c!='\\' || i+1>=raw.size()){ out.push_back(c); continue; }
+        char e = raw[++i];
+        switch(e){
+            case 'n': out.push_back('\n'); break;
+            case 't': out.push_back('\t'); break;
+            case 'r': out.push_back('\r'); break;
+            case 'a': out.push_back('\a'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'v': out.push_back('\v'); break;
+            case 'x': {
+                int v=0; size_t j=i+1;
+                while(j<raw.size() && isxdigit((unsigned char)raw[j])){ v = v*16 + (isdigit((unsigned char)raw[j]) ? raw[j]-'0' : (tolower(raw[j])-'a'+10)); j++; }
+                out.push_back((char)v); i=j-1; break;
+            }
+            default:
+                if(e>='0' && e<='7'){
+                    int v=0; size_t j=i; int n=0;
+                    while(j<raw.size() && n<3 && raw[j]>='0' && raw[j]<='7'){ v = v*8 + (raw[j]-'0'); j++; n++; }
+                    out.push_back((char)v); i=j-1;
+                } else out.push_back(e);
+        }
+    }
+    return out;
+}
+
+class AstParser {
+public:
+    using Scopes = std::vector<std::unordered_map<std::string, VarInfo*>>;
+private:
+    const CompilationUnit& unit;
+    const std::vector<Token>& toks;
+    size_t pos = 0;
+    Program& program;
+    Scopes scopes;
+    int lineBase;   // Interpolated `{expr}` parts are parsed with the line of their dekhao
+
+    const Token& cur() const { return toks[std::min(pos, toks.size()-1)]; }
+    const Token& ahead(size_t k) const { return toks[std::min(pos+k, toks.size()-1)]; }
+    int line() const { return lineBase ? lineBase : cur().line; }
+    bool isOp(const char* op) const { return cur().type=="OP" && cur().lexeme==op; }
+    bool isKeyword(const char* kw) const { return cur().type=="KEYWORD" && cur().lexeme==kw; }
+    [[noreturn]] void fail(const std::string& msg) const { throw LoweringError(line(), msg); }
+    void expect(const char* op){
+        if(!isOp(op)) fail(std::string("expected '") + op + "' near '" + cur().lexeme + "'");
+        pos++;
+    }
+    // A missing `;` is a lowering error: the C++ path passes such lines through and g++ rejects them,
+    // so the other backends must hand them back rather than accept them
+    void endStatement(int stmtLine){
+        if(isOp(";")){ pos++; return; }
+        if(lineBase) return;
+        if(optionalSemicolon && (cur().type=="EOF" || isOp("}") || cur().line>stmtLine)) return;
+        throw LoweringError(stmtLine, "expected ';' before '" + cur().lexeme + "'");
+    }
+
+    static ValueType keywordType(const std::string& kw){
+        if(kw=="purno sonkha") return ValueType::Int;
+        if(kw=="dosomik sonkha") return ValueType::Double;
+        if(kw=="lekha") return ValueType::String;
+        if(kw=="akkhor") return ValueType::Char;
+        if(kw=="sotto-mittha") return ValueType::Bool;
+        return ValueType::Void;
+    }
+    static ValueType castType(const Token& t){
+        if(t.type=="KEYWORD") return keywordType(t.lexeme);
+        if(t.type!="IDENT") return ValueType::Void;
+        if(t.lexeme=="int" || t.lexeme=="long") return ValueType::Int;
+        if(t.lexeme=="double" || t.lexeme=="float") return ValueType::Double;
+        if(t.lexeme=="char") return ValueType::Char;
+        if(t.lexeme=="bool") return ValueType::Bool;
+        return ValueType::Void;
+    }
+
+    VarInfo* declare(const std::string& name, ValueType type, bool isArray){
+        if(scopes.back().count(name)) fail("redeclaration of '" + name + "'");
+        program.vars.push_back(std::unique_ptr<VarInfo>(new VarInfo{name, type, isArray, (int)program.vars.size(), line()}));
+        return scopes.back()[name] = program.vars.back().get();
+    }
+    VarInfo* lookup(const std::string& name) const {
+        for(auto it=scopes.rbegin(); it!=scopes.rend(); ++it){ auto f=it->find(name); if(f!=it->end()) return f->second; }
+        fail("use of undeclared '" + name + "'");
+    }
+
+    ExprPtr node(Expr::Kind kind){ ExprPtr e(new Expr()); e->kind=kind; e->line=line(); return e; }
+
+    // ---- expressions, C precedence ----
+    ExprPtr expression(){ return assignment(); }
+    bool atModuloAssign() const {
+        const Token& a = cur(); const Token& b = ahead(1);
+        return a.type=="OP" && a.lexeme=="%" && b.type=="OP" && b.lexeme=="=" && b.line==a.line && b.col==a.col+1;
+    }
+    ExprPtr assignment(){
+        ExprPtr lhs = logicalOr();
+        std::string op;
+        if(isOp("=") || isOp("+=") || isOp("-=") || isOp("*=") || isOp("/=")){ op = cur().lexeme; pos++; }
+        else if(atModuloAssign()){ op = "%="; pos += 2; }
+        else return lhs;
+        if(lhs->kind!=Expr::Variable && lhs->kind!=Expr::Index) fail("assignment to a non-variable");
+        ExprPtr e = node(Expr::Assign); e->op = op;
+        e->args.push_back(std::move(lhs)); e->args.push_back(assignment());
+        return e;
+    }
+    ExprPtr logicalOr(){
+        ExprPtr e = logicalAnd();
+        while(isOp("||")){ pos++; ExprPtr n=node(Expr::Logical); n->op="||"; n->args.push_back(std::move(e)); n->args.push_back(logicalAnd()); e=std::move(n); }
+        return e;
+    }
+    ExprPtr logicalAnd(){
+        ExprPtr e = bitOr();
+        while(isOp("&&")){ pos++; ExprPtr n=node(Expr::Logical); n->op="&&"; n->args.push_back(std::move(e)); n->args.push_back(bitOr()); e=std::move(n); }
+        return e;
+    }
+    ExprPtr binaryLevel(ExprPtr (AstParser::*next)(), std::initializer_list<const char*> ops){
+        ExprPtr e = (this->*next)();
+        while(true){
+            const char* found = nullptr;
+            for(const char* op: ops) if(isOp(op) && !(std::string(op)=="%" && atModuloAssign())) found = op;
+            if(!found) return e;
+            pos++;
+            ExprPtr n=node(Expr::Binary); n->op=found; n->args.push_back(std::move(e)); n->args.push_back((this->*next)()); e=std::move(n);
+        }
+    }
+    ExprPtr bitOr(){ return binaryLevel(&AstParser::bitAnd, {"|"}); }
+    ExprPtr bitAnd(){ return binaryLevel(&AstParser::equality, {"&"}); }
+    ExprPtr equality(){ return binaryLevel(&AstParser::relational, {"==","!="}); }
+    ExprPtr relational(){ return binaryLevel(&AstParser::additive, {"<",">","<=",">="}); }
+    ExprPtr additive(){ return binaryLevel(&AstParser::multiplicative, {"+","-"}); }
+    ExprPtr multiplicative(){ return binaryLevel(&AstParser::unary, {"*","/","%"}); }
+    ExprPtr unary(){
+        if(isOp("!") || isOp("-") || isOp("+")){
+            ExprPtr e=node(Expr::Unary); e->op=cur().lexeme; pos++; e->args.push_back(unary()); return e;
+        }
+        if(isOp("++") || isOp("--")){
+            ExprPtr e=node(Expr::Step); e->op=cur().lexeme; pos++; e->args.push_back(unary());
+            if(e->args[0]->kind!=Expr::Variable && e->args[0]->kind!=Expr::Index) fail("increment of a non-variable");
+            return e;
+        }
+        if(isOp("(") && castType(ahead(1))!=ValueType::Void && ahead(2).type=="OP" && ahead(2).lexeme==")"){
+            ExprPtr e=node(Expr::Cast); e->castTo=castType(ahead(1)); pos+=3; e->args.push_back(unary()); return e;
+        }
+        return postfixExpr();
+    }
+    ExprPtr postfixExpr(){
+        ExprPtr e = primary();
+        while(true){
+            if(isOp("++") || isOp("--")){
+                if(e->kind!=Expr::Variable && e->kind!=Expr::Index) fail("increment of a non-variable");
+                ExprPtr n=node(Expr::Step); n->op=cur().lexeme; n->postfix=true; pos++; n->args.push_back(std::move(e)); e=std::move(n);
+            } else return e;
+        }
+    }
+    ExprPtr primary(){
+        const Token& t = cur();
+        if(t.type=="NUMBER"){
+            pos++;
+            if(t.lexeme.find('.')!=std::string::npos){
+                ExprPtr e=node(Expr::Real);
+                try { e->realValue=std::stod(t.lexeme); } catch(const std::exception&){ fail("real literal out of range"); }
+                return e;
+            }
+            if(t.lexeme.size()>10 || std::stoll(t.lexeme)>2147483647LL) fail("integer literal out of range");
+            ExprPtr e=node(Expr::Number); e->intValue=std::stoll(t.lexeme); return e;
+        }
+        if(t.type=="STRING"){
+            pos++; ExprPtr e=node(Expr::Text); e->text=unescapeLiteral(t.lexeme.substr(1, t.lexeme.size()-2)); return e;
+        }
+        if(t.type=="OP" && t.lexeme=="'") return charLiteral();
+        if(t.type=="IDENT"){
+            pos++;
+            if(t.lexeme=="true" || t.lexeme=="false"){ ExprPtr e=node(Expr::Boolean); e->intValue = t.lexeme=="true"; return e; }
+            VarInfo* v = lookup(t.lexeme);
+            if(isOp("[")){
+                pos++;
+                ExprPtr e=node(Expr::Index); e->op=t.lexeme; e->var=v; e->args.push_back(expression()); expect("]");
+                return e;
+            }
+            ExprPtr e=node(Expr::Variable); e->op=t.lexeme; e->var=v; return e;
+        }
+        if(isOp("(")){ pos++; ExprPtr e=expression(); expect(")"); return e; }
+        fail("unexpected '" + t.lexeme + "' in expression");
+    }
+    // The lexer splits 'x' into loose OP/IDENT tokens, so the literal is re-read from the source bytes
+    ExprPtr charLiteral(){
+        size_t at = unit.offsetOf(cur().line, cur().col) + 1;
+        const std::string& src = unit.source;
+        size_t end = at;
+        if(end<src.size() && src[end]=='\\') end += 2; else end += 1;
+        if(end>=src.size() || src[end]!='\'') fail("malformed character literal");
+        std::string value = unescapeLiteral(src.substr(at, end-at));
+        while(cur().type!="EOF" && unit.offsetOf(cur().line, cur().col) <= end) pos++;
+        ExprPtr e=node(Expr::Character); e->intValue=(signed char)value[0]; return e;
+    }
+
+    // ---- statements ----
+    StmtPtr stmt(Stmt::Kind kind){ StmtPtr s(new Stmt()); s->kind=kind; s->line=line(); return s; }
+
+    StmtPtr block(){
+        StmtPtr s = stmt(Stmt::Block);
+        expect("{");
+        scopes.emplace_back();
+        while(!isOp("}")){
+            if(cur().type=="EOF") fail("missing '}'");
+            s->body.push_back(statement());
+        }
+        pos++;
+        scopes.pop_back();
+        return s;
+    }
+    // Loop and jodi bodies get their own scope even without braces
+    StmtPtr nested(){
+        if(isOp("{")) return block();
+        scopes.emplace_back(); StmtPtr s = statement(); scopes.pop_back(); return s;
+    }
+    StmtPtr declaration(bool requireEnd){
+        int stmtLine = cur().line;
+        ValueType type = keywordType(cur().lexeme); pos++;
+        StmtPtr group = stmt(Stmt::Block); group->scoped = false;
+        while(true){
+            if(cur().type!="IDENT") fail("expected a name after the type");
+            std::string name = cur().lexeme; pos++;
+            StmtPtr s = stmt(Stmt::Declare);
+            if(isOp("[")){ pos++; s->size = expression(); expect("]"); }
+            if(isOp("=")){
+                pos++;
+                if(isOp("{")){
+                    if(!s->size) fail("initializer list on a non-array");
+                    pos++;
+                    while(!isOp("}")){ s->initList.push_back(expression()); if(isOp(",")) pos++; else break; }
+                    expect("}");
+                } else s->init = expression();
+            }
+            s->var = declare(name, type, s->size!=nullptr);
+            group->body.push_back(std::move(s));
+            if(isOp(",")){ pos++; continue; }
+            break;
+        }
+        if(requireEnd) endStatement(stmtLine);
+        if(group->body.size()==1) return std::move(group->body[0]);
+        return group;
+    }
+    StmtPtr statement(){
+        const Token& t = cur();
+        int stmtLine = t.line;
+        if(isOp("{")) return block();
+        if(isOp(";")){ pos++; StmtPtr s=stmt(Stmt::Block); s->scoped=false; return s; }
+        if(t.type=="KEYWORD"){
+            if(keywordType(t.lexeme)!=ValueType::Void) return declaration(true);
+            if(t.lexeme=="poro"){
+                pos++; StmtPtr s=stmt(Stmt::Read); expect("("); s->target=expression(); expect(")");
+                if(s->target->kind!=Expr::Variable && s->target->kind!=Expr::Index) fail("poro needs a variable");
+                endStatement(stmtLine); return s;
+            }
+            if(t.lexeme=="dekhao"){ pos++; return print(stmtLine); }
+            if(t.lexeme=="jodi"){
+                pos++; StmtPtr s=stmt(Stmt::If); expect("("); s->cond=expression(); expect(")");
+                s->then = nested();
+                if(isKeyword("nahoy jodi")){ s->otherwise = statement(); }
+                else if(isKeyword("nahoy")){ pos++; s->otherwise = nested(); }
+                return s;
+            }
+            if(t.lexeme=="nahoy jodi"){
+                // Reached only as the else-branch of a jodi: parse it as a fresh jodi
+                pos++; StmtPtr s=stmt(Stmt::If); expect("("); s->cond=expression(); expect(")");
+                s->then = nested();
+                if(isKeyword("nahoy jodi")){ s->otherwise = statement(); }
+                else if(isKeyword("nahoy")){ pos++; s->otherwise = nested(); }
+                return s;
+            }
+            if(t.lexeme=="loop"){
+                pos++; StmtPtr s=stmt(Stmt::Loop); expect("(");
+                scopes.emplace_back();
+                if(!isOp(";")){
+                    if(cur().type=="KEYWORD" && keywordType(cur().lexeme)!=ValueType::Void) s->start = declaration(false);
+                    else { s->start = stmt(Stmt::Eval); s->start->value = expression(); }
+                }
+                expect(";");
+                if(!isOp(";")) s->cond = expression();
+                expect(";");
+                if(!isOp(")")) s->step = expression();
+                expect(")");
+                s->then = nested();
+                scopes.pop_back();
+                return s;
+            }
+            if(t.lexeme=="ferot dao"){
+                pos++; StmtPtr s=stmt(Stmt::Return); s->value=expression(); endStatement(stmtLine); return s;
+            }
+            fail("unsupported statement '" + t.lexeme + "'");
+        }
+        StmtPtr s = stmt(Stmt::Eval); s->value = expression(); endStatement(stmtLine); return s;
+    }
+    StmtPtr print(int stmtLine){
+        StmtPtr s = stmt(Stmt::Print);
+        const Token& t = cur();
+        const Token& after = ahead(1);
+        bool ends = after.type=="EOF" || (after.type=="OP" && (after.lexeme==";" || after.lexeme=="}")) || after.line>stmtLine;
+        if(t.type=="OP" && t.lexeme=="\\" && after.type=="IDENT" && after.lexeme=="n"){
+            pos += 2; s->parts.push_back({true, "\n", nullptr});
+        } else if(t.type=="STRING" && ends){
+            pos++; interpolate(t.lexeme.substr(1, t.lexeme.size()-2), s->parts);
+        } else {
+            s->parts.push_back({false, "", expression()});
+        }
+        endStatement(stmtLine);
+        return s;
+    }
+    // Same split as Transpiler::renderDekhao: text outside {..} is literal, text inside is an expression
+    void interpolate(const std::string& body, std::vector<PrintPart>& parts){
+        std::string cur; bool inBrace=false;
+        for(char c: body){
+            if(!inBrace && c=='{'){ inBrace=true; if(!cur.empty()){ parts.push_back({true, unescapeLiteral(cur), nullptr}); cur.clear(); } }
+            else if(inBrace && c=='}'){ inBrace=false; if(!cur.empty()){ parts.push_back({false, "", subExpression(cur)}); cur.clear(); } }
+            else cur.push_back(c);
+        }
+        if(!cur.empty()) parts.push_back({true, unescapeLiteral(cur), nullptr});
+    }
+    ExprPtr subExpression(const std::string& text){
+        CompilationUnit sub(text);
+        Lexer lexer(sub.source); lexer.lex(); sub.tokens = std::move(lexer.tokens);
+        AstParser inner(sub, program, scopes, line());
+        ExprPtr e = inner.expression();
+        if(inner.cur().type!="EOF") inner.fail("unexpected '" + inner.cur().lexeme + "' in interpolation");
+        return e;
+    }
+
+    AstParser(const CompilationUnit& u, Program& p, const Scopes& outer, int base)
+        : unit(u), toks(u.tokens), program(p), scopes(outer), lineBase(base) {}
+public:
+    AstParser(const CompilationUnit& u, Program& p) : unit(u), toks(u.tokens), program(p), scopes(1), lineBase(0) {}
+
+    // shuru <statements> shesh
+    void parseProgram(){
+        if(isKeyword("shuru")) pos++;
+        while(cur().type!="EOF" && !isKeyword("shesh")) program.body.push_back(statement());
+        program.lastLine = cur().line;
+    }
+    // One statement at a time for callers that keep scopes alive between inputs (the REPL): names in
+    // `outer` are visible, and scopes() afterwards also holds what the statements declared at top level
+    AstParser(const CompilationUnit& u, Program& p, const Scopes& outer) : AstParser(u, p, outer, 0) {}
+    bool optionalSemicolon = false;  // A statement may end at its line without `;` (the REPL)
+    bool atEnd() const { return cur().type=="EOF"; }
+    StmtPtr nextStatement(){ return statement(); }
+    const Scopes& visible() const { return scopes; }
+};
+
+// ---- typing ----
+
+inline bool isNumeric(ValueType t){ return t==ValueType::Int || t==ValueType::Double || t==ValueType::Char || t==ValueType::Bool; }
+
+// C++ usual arithmetic conversions restricted to the Banglish types
+inline ValueType arithmeticType(ValueType a, ValueType b){
+    return (a==ValueType::Double || b==ValueType::Double) ? ValueType::Double : ValueType::Int;
+}
+
+inline void typeExpr(Expr& e){
+    for(auto& a: e.args) typeExpr(*a);
+    auto need = [&](bool ok, const char* what){ if(!ok) throw LoweringError(e.line, what); };
+    switch(e.kind){
+        case Expr::Number: e.type = ValueType::Int; break;
+        case Expr::Real: e.type = ValueType::Double; break;
+        case Expr::Text: e.type = ValueType::String; break;
+        case Expr::Character: e.type = ValueType::Char; break;
+        case Expr::Boolean: e.type = ValueType::Bool; break;
+        case Expr::Variable:
+            need(!e.var->isArray, "array used without an index");
+            e.type = e.var->type; break;
+        case Expr::Index:
+            need(e.var->isArray, "index into a non-array");
+            need(isNumeric(e.args[0]->type) && e.args[0]->type!=ValueType::Double, "array index must be an integer");
+            e.type = e.var->type; break;
+        case Expr::Unary:
+            need(isNumeric(e.args[0]->type), "unary operator on a non-number");
+            e.type = e.op=="!" ? ValueType::Bool : (e.args[0]->type==ValueType::Double ? ValueType::Double : ValueType::Int);
+            break;
+        case Expr::Logical:
+            need(isNumeric(e.args[0]->type) && isNumeric(e.args[1]->type), "logical operator on a non-number");
+            e.type = ValueType::Bool; break;
+        case Expr::Binary: {
+            ValueType a = e.args[0]->type, b = e.args[1]->type;
+            bool cmp = e.op=="==" || e.op=="!=" || e.op=="<" || e.op==">" || e.op=="<=" || e.op==">=";
+            if(a==ValueType::String || b==ValueType::String){
+                // As in C++, one side must be a real std::string; a literal alone is a char pointer
+                auto isObject = [](const Expr& x){ return x.type==ValueType::String && x.kind!=Expr::Text; };
+                need(isObject(*e.args[0]) || isObject(*e.args[1]), "string operation on literals only");
+                if(cmp) need(a==ValueType::String && b==ValueType::String, "comparing a string with a non-string");
+                else need(e.op=="+" && (a==ValueType::String || a==ValueType::Char) && (b==ValueType::String || b==ValueType::Char), "unsupported string operation");
+                e.type = cmp ? ValueType::Bool : ValueType::String;
+                break;
+            }
+            need(isNumeric(a) && isNumeric(b), "operator on a non-number");
+            if(cmp) e.type = ValueType::Bool;
+            else if(e.op=="%" || e.op=="&" || e.op=="|"){ need(a!=ValueType::Double && b!=ValueType::Double, "integer operator on a double"); e.type = ValueType::Int; }
+            else e.type = arithmeticType(a, b);
+            break;
+        }
+        case Expr::Assign: {
+            ValueType t = e.args[0]->type, v = e.args[1]->type;
+            if(t==ValueType::String) need(v==ValueType::String || (e.op=="+=" && v==ValueType::Char) || (e.op=="=" && v==ValueType::Char), "bad string assignment");
+            else need(isNumeric(v), "assigning a string to a number");
+            if(t==ValueType::String) need(e.op=="=" || e.op=="+=", "unsupported string operator");
+            if(e.op=="%=") need(t!=ValueType::Double && v!=ValueType::Double, "integer operator on a double");
+            e.type = t; break;
+        }
+        case Expr::Step:
+            need(isNumeric(e.args[0]->type) && e.args[0]->type!=ValueType::Bool, "increment of a non-number");
+            e.type = e.args[0]->type; break;
+        case Expr::Cast:
+            need(isNumeric(e.args[0]->type), "cast of a non-number");
+            e.type = e.castTo; break;
+    }
+}
+
+inline void typeStmt(Stmt& s){
+    auto need = [&](bool ok, const char* what){ if(!ok) throw LoweringError(s.line, what); };
+    auto sub = [](ExprPtr& e){ if(e) typeExpr(*e); };
+    sub(s.size); sub(s.init); for(auto& e: s.initList) typeExpr(*e);
+    sub(s.target); sub(s.cond); sub(s.step); sub(s.value);
+    for(auto& p: s.parts) if(p.expr) typeExpr(*p.expr);
+    if(s.then) typeStmt(*s.then);
+    if(s.otherwise) typeStmt(*s.otherwise);
+    if(s.start) typeStmt(*s.start);
+    for(auto& b: s.body) typeStmt(*b);
+    switch(s.kind){
+        case Stmt::Declare:
+            if(s.size) need(isNumeric(s.size->type) && s.size->type!=ValueType::Double, "array size must be an integer");
+            if(s.init){
+                if(s.var->type==ValueType::String) need(s.init->type==ValueType::String, "bad string initializer");
+                else need(isNumeric(s.init->type), "bad initializer");
+            }
+            for(auto& e: s.initList) need(s.var->type==ValueType::String ? e->type==ValueType::String : isNumeric(e->type), "bad array initializer");
+            break;
+        case Stmt::If: case Stmt::Loop:
+            if(s.cond) need(isNumeric(s.cond->type), "condition must be a number");
+            break;
+        case Stmt::Return:
+            need(isNumeric(s.value->type), "ferot dao needs a number");
+            break;
+        default: break;
+    }
+}
+
+// Parses and types a whole unit; throws LoweringError for anything outside the supported subset
+inline void buildProgram(const CompilationUnit& unit, Program& program){
+    AstParser parser(unit, program);
+    parser.parseProgram();
+    for(auto& s: program.body) typeStmt(*s);
+}
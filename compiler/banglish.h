@@ -1,5 +1,6 @@
 #pragma once
 #include "token.h"
 #include "symbol_table.h"
+#include "compilation_unit.h"
 #include "lexer.h"
 #include "transpiler.h"
@@ -0,0 +1,257 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// --bench settings: how often to run the built program, under which limits, and what to compare against
+struct BenchConfig {
+    unsigned runs = 10;
+    unsigned warmup = 2;            // Runs before measuring, to warm the page cache and the CPU's caches
+    int cpu = -1;                   // CPU the runs are pinned to; -1 picks the last one the driver may use
+    unsigned cpuSeconds = 0;        // RLIMIT_CPU for each run, 0 for none
+    unsigned memoryMb = 0;          // RLIMIT_AS for each run, 0 for none
+    std::string baselinePath = "bench_baseline.json";
+    bool saveBaseline = false;      // Replace the baseline with this run's numbers
+    double tolerance = 5;           // Median wall time may grow this many percent before it is a regression
+};
+
+// One measured run, from wait4's rusage and the wall clock around fork..wait4
+struct BenchSample {
+    double wallMs = 0, userMs = 0, sysMs = 0;
+    long maxRssKb = 0, minorFaults = 0, majorFaults = 0;
+    int status = 0;                 // waitpid form
+};
+
+struct BenchStats { double mean = 0, median = 0, p95 = 0, stddev = 0; };
+
+inline BenchStats benchStats(std::vector<double> values){
+    BenchStats s;
+    if(values.empty()) return s;
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    for(double v: values) s.mean += v;
+    s.mean /= n;
+    s.median = n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+    s.p95 = values[(size_t)std::ceil(0.95 * n) - 1];  // Nearest rank
+    for(double v: values) s.stddev += (v - s.mean) * (v - s.mean);
+    s.stddev = n > 1 ? std::sqrt(s.stddev / (n - 1)) : 0;
+    return s;
+}
+
+// What a benchmark measured; also the contents of a baseline file
+struct BenchResult {
+    bool ran = false;
+    std::string note;               // Why the benchmark stopped early, or what could not be applied
+    int pinnedCpu = -1;
+    std::string codeHash, inputHash; // Identify the binary's build and the input it ran on
+    unsigned runs = 0;
+    BenchStats wall, user, sys;
+    double maxRssKb = 0, minorFaults = 0, majorFaults = 0;  // Peak RSS is the largest run's, faults the mean
+};
+
+#ifndef _WIN32
+// Picks the CPU to pin to: the requested one if the driver may run there, else the highest allowed one
+inline int benchCpu(int requested){
+#ifdef __linux__
+    cpu_set_t allowed;
+    if(sched_getaffinity(0, sizeof allowed, &allowed) != 0) return -1;
+    if(requested >= 0) return requested < CPU_SETSIZE && CPU_ISSET(requested, &allowed) ? requested : -1;
+    for(int cpu = CPU_SETSIZE - 1; cpu >= 0; --cpu) if(CPU_ISSET(cpu, &allowed)) return cpu;
+#endif
+    (void)requested;
+    return -1;
+}
+
+// Runs executable once with stdin from inputPath and stdout discarded, pinned and limited as configured
+inline BenchSample benchRunOnce(const std::string& executable, const std::string& inputPath, const BenchConfig& config, int cpu){
+    BenchSample sample;
+    // Opened per run: the child shares the file offset, so a reused descriptor would start at EOF
+    int in = open(inputPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if(in < 0) in = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    int out = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if(pid == 0){
+        dup2(in, 0);
+        dup2(out, 1);
+#ifdef __linux__
+        if(cpu >= 0){
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            sched_setaffinity(0, sizeof set, &set);
+        }
+#endif
+        if(config.cpuSeconds){
+            rlimit limit{config.cpuSeconds, config.cpuSeconds + 1};
+            setrlimit(RLIMIT_CPU, &limit);
+        }
+        if(config.memoryMb){
+            rlimit limit{(rlim_t)config.memoryMb << 20, (rlim_t)config.memoryMb << 20};
+            setrlimit(RLIMIT_AS, &limit);
+        }
+        execl(executable.c_str(), executable.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+    close(in);
+    close(out);
+    if(pid < 0){ sample.status = -1; return sample; }
+    rusage usage{};
+    while(wait4(pid, &sample.status, 0, &usage) < 0 && errno == EINTR){}
+    sample.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    sample.userMs = usage.ru_utime.tv_sec * 1e3 + usage.ru_utime.tv_usec / 1e3;
+    sample.sysMs = usage.ru_stime.tv_sec * 1e3 + usage.ru_stime.tv_usec / 1e3;
+#ifdef __APPLE__
+    sample.maxRssKb = usage.ru_maxrss / 1024;  // Bytes there, kilobytes on Linux
+#else
+    sample.maxRssKb = usage.ru_maxrss;
+#endif
+    sample.minorFaults = usage.ru_minflt;
+    sample.majorFaults = usage.ru_majflt;
+    return sample;
+}
+#endif
+
+// Warms up, then measures config.runs runs. Stops at the first run that fails, since its numbers
+// would describe a crash (or a limit being hit) rather than the program.
+inline BenchResult runBenchmark(const std::string& executable, const std::string& inputPath, const BenchConfig& config){
+    BenchResult result;
+#ifndef _WIN32
+    result.pinnedCpu = benchCpu(config.cpu);
+    if(config.cpu >= 0 && result.pinnedCpu < 0) result.note = "CPU " + std::to_string(config.cpu) + " is not available, running unpinned";
+    std::vector<double> wall, user, sys;
+    for(unsigned k = 0; k < config.warmup + config.runs; ++k){
+        BenchSample s = benchRunOnce(executable, inputPath, config, result.pinnedCpu);
+        if(!WIFEXITED(s.status) || WEXITSTATUS(s.status) == 127){
+            int sig = WIFSIGNALED(s.status) ? WTERMSIG(s.status) : 0;
+            result.note = "run " + std::to_string(k + 1) + (sig == SIGXCPU ? " hit the CPU time limit"
+                        : sig ? " was killed by signal " + std::to_string(sig)
+                        : config.memoryMb ? " could not start the program, the memory limit may be too low" : " could not start the program");
+            return result;
+        }
+        if(k < config.warmup) continue;
+        wall.push_back(s.wallMs);
+        user.push_back(s.userMs);
+        sys.push_back(s.sysMs);
+        result.maxRssKb = std::max(result.maxRssKb, (double)s.maxRssKb);
+        result.minorFaults += (double)s.minorFaults / config.runs;
+        result.majorFaults += (double)s.majorFaults / config.runs;
+    }
+    result.ran = !wall.empty();
+    result.runs = (unsigned)wall.size();
+    result.wall = benchStats(wall);
+    result.user = benchStats(user);
+    result.sys = benchStats(sys);
+#else
+    (void)executable; (void)inputPath; (void)config;
+    result.note = "--bench needs fork() and wait4()";
+#endif
+    return result;
+}
+
+// Baselines are a small flat JSON document; nested objects are read back as "wall_ms.median" and so on
+inline std::string benchJson(const BenchResult& r){
+    std::ostringstream out;
+    out.precision(6);
+    auto stats = [&](const char* name, const BenchStats& s){
+        out << "  \"" << name << "\": {\"mean\": " << s.mean << ", \"median\": " << s.median
+            << ", \"p95\": " << s.p95 << ", \"stddev\": " << s.stddev << "},\n";
+    };
+    out << "{\n  \"format\": 1,\n  \"code_hash\": \"" << r.codeHash << "\",\n  \"input_hash\": \"" << r.inputHash << "\",\n"
+        << "  \"runs\": " << r.runs << ",\n";
+    stats("wall_ms", r.wall);
+    stats("user_ms", r.user);
+    stats("sys_ms", r.sys);
+    out << "  \"max_rss_kb\": " << r.maxRssKb << ",\n  \"minor_faults\": " << r.minorFaults
+        << ",\n  \"major_faults\": " << r.majorFaults << "\n}\n";
+    return out.str();
+}
+
+// Reads what benchJson writes (strings without escapes, numbers, nested objects); false if it is not that
+inline bool parseBenchJson(const std::string& text, std::map<std::string, std::string>& fields){
+    size_t at = 0;
+    auto blank = [&]{ while(at < text.size() && std::isspace((unsigned char)text[at])) ++at; };
+    auto quoted = [&](std::string& s){
+        blank();
+        if(at >= text.size() || text[at] != '"') return false;
+        size_t end = text.find('"', at + 1);
+        if(end == std::string::npos) return false;
+        s = text.substr(at + 1, end - at - 1);
+        at = end + 1;
+        return true;
+    };
+    std::function<bool(const std::string&)> object = [&](const std::string& prefix){
+        blank();
+        if(at >= text.size() || text[at++] != '{') return false;
+        blank();
+        if(at < text.size() && text[at] == '}'){ ++at; return true; }
+        while(true){
+            std::string key;
+            if(!quoted(key)) return false;
+            blank();
+            if(at >= text.size() || text[at++] != ':') return false;
+            blank();
+            if(at < text.size() && text[at] == '{'){
+                if(!object(prefix + key + ".")) return false;
+            } else if(at < text.size() && text[at] == '"'){
+                if(!quoted(fields[prefix + key])) return false;
+            } else {
+                size_t end = text.find_first_of(",}", at);
+                if(end == std::string::npos) return false;
+                std::string number = text.substr(at, end - at);
+                while(!number.empty() && std::isspace((unsigned char)number.back())) number.pop_back();
+                fields[prefix + key] = number;
+                at = end;
+            }
+            blank();
+            if(at >= text.size()) return false;
+            char c = text[at++];
+            if(c == '}') return true;
+            if(c != ',') return false;
+        }
+    };
+    return object("");
+}
+
+inline bool loadBenchBaseline(const std::string& path, BenchResult& baseline){
+    std::ifstream file(path, std::ios::binary);
+    std::map<std::string, std::string> f;
+    if(!file || !parseBenchJson(std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()), f)) return false;
+    if(f["format"] != "1") return false;
+    auto number = [&](const std::string& key){ return std::atof(f[key].c_str()); };
+    auto stats = [&](const std::string& name){
+        return BenchStats{number(name + ".mean"), number(name + ".median"), number(name + ".p95"), number(name + ".stddev")};
+    };
+    baseline.ran = true;
+    baseline.codeHash = f["code_hash"];
+    baseline.inputHash = f["input_hash"];
+    baseline.runs = (unsigned)number("runs");
+    baseline.wall = stats("wall_ms");
+    baseline.user = stats("user_ms");
+    baseline.sys = stats("sys_ms");
+    baseline.maxRssKb = number("max_rss_kb");
+    baseline.minorFaults = number("minor_faults");
+    baseline.majorFaults = number("major_faults");
+    return baseline.wall.median > 0;
+}
@@ -0,0 +1,229 @@
+#pragma once
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "native_runtime.h"
+#include "transpiler.h"
+
+// Emits C99 for a typed Program. Numbers map onto C arithmetic with the same promotions as the
+// C++ backend; lekha values are runtime bg_str buffers that are freed when their scope closes.
+class CCodegen {
+private:
+    std::ostringstream out;
+    int depth = 1;
+    std::vector<std::vector<const VarInfo*>> cleanups;  // Strings and heap arrays owned by each open scope
+    std::vector<bool> onHeap;                            // Indexed by VarInfo::id
+
+    [[noreturn]] static void unsupported(int line, const std::string& what){ throw LoweringError(line, what + " is not supported by the C backend"); }
+    static const char* cType(ValueType t){
+        switch(t){
+            case ValueType::Int: return "int";
+            case ValueType::Double: return "double";
+            case ValueType::Char: return "char";
+            case ValueType::Bool: return "bool";
+            default: return "bg_str";
+        }
+    }
+    static size_t elementBytes(ValueType t){ return t==ValueType::Int ? 4 : t==ValueType::Double ? 8 : t==ValueType::String ? sizeof(void*)*3 : 1; }
+    // Declarations get their id appended so Banglish names never clash with C keywords or shadowing rules
+    // C99 only takes some of the Bengali block in identifiers, so non-ASCII bytes are spelled out as _xHH
+    static std::string name(const VarInfo* v){
+        std::string n;
+        for(unsigned char c: v->name){
+            if(c<0x80){ n += (char)c; continue; }
+            n += "_x"; n += "0123456789ABCDEF"[c>>4]; n += "0123456789ABCDEF"[c&15];
+        }
+        return n + "_" + std::to_string(v->id);
+    }
+    static std::string quote(const std::string& s){
+        std::string q = "\"";
+        for(unsigned char c: s){
+            if(c=='"' || c=='\\'){ q += '\\'; q += (char)c; }
+            else if(c=='\n') q += "\\n";
+            else if(c=='\t') q += "\\t";
+            else if(c<32 || c>126 || c=='?'){ char b[8]; snprintf(b, sizeof b, "\\%03o", c); q += b; }
+            else q += (char)c;
+        }
+        return q + "\"";
+    }
+    void line(const std::string& s){ out << std::string(depth*4, ' ') << s << "\n"; }
+
+    static bool isLvalue(const Expr& e){ return e.kind==Expr::Variable || e.kind==Expr::Index; }
+    std::string lvalue(const Expr& e){
+        if(e.kind==Expr::Variable) return name(e.var);
+        return name(e.var) + "[" + expr(*e.args[0]) + "]";
+    }
+    // A freshly allocated bg_str holding the value of a string (or char) expression
+    std::string owned(const Expr& e){
+        if(e.type==ValueType::Char) return "bg_str_char(" + expr(e) + ")";
+        switch(e.kind){
+            case Expr::Text: return "bg_str_lit(" + quote(e.text) + ", " + std::to_string(std::min(e.text.size(), e.text.find('\0'))) + ")";
+            case Expr::Variable: case Expr::Index: return "bg_str_dup(&" + lvalue(e) + ")";
+            case Expr::Binary: return "bg_str_cat(" + owned(*e.args[0]) + ", " + owned(*e.args[1]) + ")";
+            default: unsupported(e.line, "this string expression");
+        }
+    }
+    std::string expr(const Expr& e){
+        switch(e.kind){
+            case Expr::Number: case Expr::Character: return std::to_string(e.intValue);
+            case Expr::Boolean: return e.intValue ? "true" : "false";
+            case Expr::Real: {
+                char b[40]; snprintf(b, sizeof b, "%.17g", e.realValue);
+                std::string r = b; if(r.find_first_of(".en")==std::string::npos) r += ".0";
+                return r;
+            }
+            case Expr::Text: unsupported(e.line, "a string value here");
+            case Expr::Variable: case Expr::Index:
+                if(e.type==ValueType::String) unsupported(e.line, "a string value here");
+                return lvalue(e);
+            case Expr::Cast: return std::string("((") + cType(e.castTo) + ")" + expr(*e.args[0]) + ")";
+            case Expr::Unary: return "(" + e.op + expr(*e.args[0]) + ")";
+            case Expr::Logical: return "(" + expr(*e.args[0]) + " " + e.op + " " + expr(*e.args[1]) + ")";
+            case Expr::Binary:
+                if(e.args[0]->type==ValueType::String || e.args[1]->type==ValueType::String){
+                    if(e.type==ValueType::String) unsupported(e.line, "a string value here");
+                    if(isLvalue(*e.args[0]) && isLvalue(*e.args[1]))
+                        return "(bg_str_cmp_ref(&" + lvalue(*e.args[0]) + ", &" + lvalue(*e.args[1]) + ") " + e.op + " 0)";
+                    return "(bg_str_cmp(" + owned(*e.args[0]) + ", " + owned(*e.args[1]) + ") " + e.op + " 0)";
+                }
+                return "(" + expr(*e.args[0]) + " " + e.op + " " + expr(*e.args[1]) + ")";
+            case Expr::Assign:
+                if(e.type==ValueType::String) unsupported(e.line, "a string assignment inside an expression");
+                return "(" + lvalue(*e.args[0]) + " " + e.op + " " + expr(*e.args[1]) + ")";
+            case Expr::Step:
+                return e.postfix ? "(" + lvalue(*e.args[0]) + e.op + ")" : "(" + e.op + lvalue(*e.args[0]) + ")";
+        }
+        unsupported(e.line, "this expression");
+    }
+
+    void openScope(){ cleanups.emplace_back(); }
+    void closeScope(){
+        for(auto it=cleanups.back().rbegin(); it!=cleanups.back().rend(); ++it){
+            const VarInfo* v = *it;
+            if(!v->isArray){ line("bg_str_free(&" + name(v) + ");"); continue; }
+            if(v->type==ValueType::String) line("for(long long bg_i = 0; bg_i < " + name(v) + "_n; ++bg_i) bg_str_free(&" + name(v) + "[bg_i]);");
+            if(onHeap[v->id]) line("free(" + name(v) + ");");
+        }
+        cleanups.pop_back();
+    }
+    // Bodies of jodi/loop always get braces so their declarations are released each pass
+    void body(const Stmt& s){
+        depth++; openScope();
+        if(s.kind==Stmt::Block && s.scoped) for(auto& b: s.body) stmt(*b); else stmt(s);
+        closeScope(); depth--;
+    }
+
+    void declare(const Stmt& s){
+        const VarInfo* v = s.var;
+        std::string n = name(v), t = cType(v->type);
+        if(!v->isArray){
+            if(v->type==ValueType::String){
+                line("bg_str " + n + " = " + (s.init ? owned(*s.init) : std::string("bg_str_lit(\"\", 0)")) + ";");
+                cleanups.back().push_back(v);
+            } else line(t + " " + n + " = " + (s.init ? expr(*s.init) : std::string("0")) + ";");
+            return;
+        }
+        // Same placement rule as Transpiler::fitsOnStack: literal sizes that fit stay on the stack
+        bool literal = s.size->kind==Expr::Number;
+        bool stack = literal && (s.initList.size() || (unsigned long long)s.size->intValue * elementBytes(v->type) <= BG_STACK_ARRAY_BYTES);
+        if(!s.initList.empty() && !literal) unsupported(s.line, "an initializer list on a runtime-sized array");
+        onHeap[v->id] = !stack;
+        if(stack){
+            std::string init;
+            for(auto& e: s.initList) init += (init.empty() ? "" : ", ") + (v->type==ValueType::String ? owned(*e) : expr(*e));
+            if(init.empty()) init = v->type==ValueType::String ? "{0}" : "0";
+            line(t + " " + n + "[" + std::to_string(s.size->intValue) + "] = {" + init + "};");
+            if(v->type==ValueType::String) line("const long long " + n + "_n = " + std::to_string(s.size->intValue) + ";");
+        } else {
+            line("long long " + n + "_n = " + expr(*s.size) + ";");
+            line(t + "* " + n + " = (" + t + "*)bg_alloc_array(" + n + "_n, sizeof(" + t + "));");
+        }
+        if(v->type==ValueType::String || !stack) cleanups.back().push_back(v);
+    }
+
+    void print(const Expr& e){
+        if(e.kind==Expr::Text){ line("bg_print_str(" + quote(e.text) + ");"); return; }
+        switch(e.type){
+            case ValueType::Double: line("bg_print_double(" + expr(e) + ");"); break;
+            case ValueType::Char: line("bg_print_char(" + expr(e) + ");"); break;
+            case ValueType::String:
+                if(isLvalue(e)) line("bg_print_bgstr_ref(&" + lvalue(e) + ");");
+                else line("bg_print_bgstr(" + owned(e) + ");");
+                break;
+            default: line("bg_print_int(" + expr(e) + ");");
+        }
+    }
+
+    void stmt(const Stmt& s){
+        switch(s.kind){
+            case Stmt::Block:
+                if(!s.scoped){ for(auto& b: s.body) stmt(*b); break; }
+                line("{"); body(s); line("}");
+                break;
+            case Stmt::Declare: declare(s); break;
+            case Stmt::Read: {
+                const Expr& t = *s.target;
+                switch(t.type){
+                    case ValueType::Int: line("bg_read_int(&" + lvalue(t) + ");"); break;
+                    case ValueType::Double: line("bg_read_double(&" + lvalue(t) + ");"); break;
+                    case ValueType::Char: line("bg_read_char(&" + lvalue(t) + ");"); break;
+                    case ValueType::Bool: line("bg_read_bool((char*)&" + lvalue(t) + ");"); break;
+                    default: line("bg_read_line(&" + lvalue(t) + ");");
+                }
+                break;
+            }
+            case Stmt::Print:
+                for(auto& p: s.parts){
+                    if(p.isText) line("bg_print_str(" + quote(p.text) + ");");
+                    else print(*p.expr);
+                }
+                break;
+            case Stmt::If: {
+                line("if (" + expr(*s.cond) + ") {");
+                body(*s.then);
+                const Stmt* other = s.otherwise.get();
+                while(other && other->kind==Stmt::If){
+                    line("} else if (" + expr(*other->cond) + ") {");
+                    body(*other->then);
+                    other = other->otherwise.get();
+                }
+                if(other){ line("} else {"); body(*other); }
+                line("}");
+                break;
+            }
+            case Stmt::Loop:
+                line("{");
+                depth++; openScope();
+                if(s.start) stmt(*s.start);
+                line("for (; " + (s.cond ? expr(*s.cond) : std::string("")) + "; " + (s.step ? expr(*s.step) : std::string("")) + ") {");
+                body(*s.then);
+                line("}");
+                closeScope(); depth--;
+                line("}");
+                break;
+            case Stmt::Return: line("bg_exit(" + expr(*s.value) + ");"); break;
+            case Stmt::Eval: {
+                const Expr& e = *s.value;
+                if(e.kind==Expr::Assign && e.type==ValueType::String){
+                    line((e.op=="=" ? "bg_str_set(&" : "bg_str_append(&") + lvalue(*e.args[0]) + ", " + owned(*e.args[1]) + ");");
+                } else if(e.type==ValueType::String){
+                    unsupported(s.line, "a string value as a statement");
+                } else line(expr(e) + ";");
+                break;
+            }
+        }
+    }
+
+public:
+    // Returns a complete C99 translation unit; throws LoweringError for constructs outside the C subset
+    std::string generate(const Program& program){
+        onHeap.assign(program.vars.size(), false);
+        openScope();
+        for(auto& s: program.body) stmt(*s);
+        closeScope();
+        line("bg_exit(0);");
+        return std::string(BG_NATIVE_RUNTIME_DECLS) + "#include <stdlib.h>\n\nint main(void){\n" + out.str() + "}\n";
+    }
+};
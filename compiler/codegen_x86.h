@@ -0,0 +1,299 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "native_runtime.h"
+
+// Lowers a typed Program to AT&T x86-64 assembly (System V ABI). Expressions are evaluated
+// stack-machine style: integers, chars and bools in %eax, doubles in %xmm0.
+class X86Codegen {
+private:
+    std::ostringstream text, rodata;
+    int labels = 0;
+    std::vector<std::vector<const VarInfo*>> cleanups;  // Heap arrays of each open block, freed when it ends
+
+    std::string label(){ return ".Lbg" + std::to_string(labels++); }
+    [[noreturn]] static void unsupported(int line, const std::string& what){ throw LoweringError(line, what + " is not supported by the native backend"); }
+    static bool isDouble(ValueType t){ return t==ValueType::Double; }
+    static int elementSize(ValueType t){ return t==ValueType::Int ? 4 : t==ValueType::Double ? 8 : 1; }
+    static std::string slot(const VarInfo* v){ return std::to_string(-8*(v->id+1)) + "(%rbp)"; }
+
+    void emit(const std::string& s){ text << "\t" << s << "\n"; }
+    void push(ValueType t){
+        if(isDouble(t)){ emit("subq $8, %rsp"); emit("movsd %xmm0, (%rsp)"); }
+        else emit("pushq %rax");
+    }
+    // Pops into the second operand register: %ecx or %xmm1
+    void popSecond(ValueType t){
+        if(isDouble(t)){ emit("movsd (%rsp), %xmm1"); emit("addq $8, %rsp"); }
+        else emit("popq %rcx");
+    }
+
+    void convert(ValueType from, ValueType to){
+        if(to==ValueType::Int || to==ValueType::String || to==ValueType::Void){ if(isDouble(from) && to==ValueType::Int) emit("cvttsd2si %xmm0, %eax"); return; }
+        if(to==ValueType::Double){ if(!isDouble(from)) emit("cvtsi2sdl %eax, %xmm0"); return; }
+        if(to==ValueType::Char){ if(isDouble(from)) emit("cvttsd2si %xmm0, %eax"); emit("movsbl %al, %eax"); return; }
+        // Bool: non-zero (and NaN) is true
+        if(from==ValueType::Bool) return;
+        if(isDouble(from)){
+            emit("xorpd %xmm1, %xmm1"); emit("ucomisd %xmm1, %xmm0");
+            emit("setne %al"); emit("setp %cl"); emit("orb %cl, %al"); emit("movzbl %al, %eax");
+        } else { emit("testl %eax, %eax"); emit("setne %al"); emit("movzbl %al, %eax"); }
+    }
+    void load(ValueType t, const std::string& at){
+        switch(t){
+            case ValueType::Int: emit("movl " + at + ", %eax"); break;
+            case ValueType::Double: emit("movsd " + at + ", %xmm0"); break;
+            case ValueType::Char: emit("movsbl " + at + ", %eax"); break;
+            default: emit("movzbl " + at + ", %eax");
+        }
+    }
+    void store(ValueType t, const std::string& at){
+        if(t==ValueType::Int) emit("movl %eax, " + at);
+        else if(isDouble(t)) emit("movsd %xmm0, " + at);
+        else emit("movb %al, " + at);
+    }
+    // Leaves the address of a Variable/Index target in %rsi
+    void address(const Expr& e){
+        if(e.kind==Expr::Variable){ emit("leaq " + slot(e.var) + ", %rsi"); return; }
+        gen(*e.args[0]);
+        convert(e.args[0]->type, ValueType::Int);
+        emit("movslq %eax, %rcx");
+        emit("movq " + slot(e.var) + ", %rsi");
+        emit("leaq (%rsi,%rcx," + std::to_string(elementSize(e.var->type)) + "), %rsi");
+    }
+    std::string doubleConstant(double v){
+        uint64_t bits; std::memcpy(&bits, &v, sizeof bits);
+        std::string l = label();
+        rodata << "\t.p2align 3\n" << l << ":\n\t.quad " << bits << "\n";
+        return l;
+    }
+    std::string stringConstant(const std::string& s){
+        std::string l = label();
+        rodata << l << ":\n\t.string \"";
+        for(unsigned char c: s){
+            if(c=='"' || c=='\\') rodata << '\\' << c;
+            else if(c<32 || c>126){ char b[8]; snprintf(b, sizeof b, "\\%03o", c); rodata << b; }
+            else rodata << c;
+        }
+        rodata << "\"\n";
+        return l;
+    }
+
+    // Applies op to (%eax, %ecx) or (%xmm0, %xmm1) computed in type t; comparisons leave a bool in %eax
+    void arithmetic(const std::string& op, ValueType t){
+        if(isDouble(t)){
+            if(op=="+") emit("addsd %xmm1, %xmm0");
+            else if(op=="-") emit("subsd %xmm1, %xmm0");
+            else if(op=="*") emit("mulsd %xmm1, %xmm0");
+            else if(op=="/") emit("divsd %xmm1, %xmm0");
+            // Unordered compares (NaN) set CF/ZF/PF, so a/ae on swapped operands stay false
+            else if(op=="<"){ emit("ucomisd %xmm0, %xmm1"); emit("seta %al"); emit("movzbl %al, %eax"); }
+            else if(op=="<="){ emit("ucomisd %xmm0, %xmm1"); emit("setae %al"); emit("movzbl %al, %eax"); }
+            else if(op==">"){ emit("ucomisd %xmm1, %xmm0"); emit("seta %al"); emit("movzbl %al, %eax"); }
+            else if(op==">="){ emit("ucomisd %xmm1, %xmm0"); emit("setae %al"); emit("movzbl %al, %eax"); }
+            else if(op=="=="){ emit("ucomisd %xmm1, %xmm0"); emit("sete %al"); emit("setnp %cl"); emit("andb %cl, %al"); emit("movzbl %al, %eax"); }
+            else if(op=="!="){ emit("ucomisd %xmm1, %xmm0"); emit("setne %al"); emit("setp %cl"); emit("orb %cl, %al"); emit("movzbl %al, %eax"); }
+            return;
+        }
+        if(op=="+") emit("addl %ecx, %eax");
+        else if(op=="-") emit("subl %ecx, %eax");
+        else if(op=="*") emit("imull %ecx, %eax");
+        else if(op=="/"){ emit("cltd"); emit("idivl %ecx"); }
+        else if(op=="%"){ emit("cltd"); emit("idivl %ecx"); emit("movl %edx, %eax"); }
+        else if(op=="&") emit("andl %ecx, %eax");
+        else if(op=="|") emit("orl %ecx, %eax");
+        else {
+            const char* set = op=="<" ? "setl" : op=="<=" ? "setle" : op==">" ? "setg" : op==">=" ? "setge" : op=="==" ? "sete" : "setne";
+            emit("cmpl %ecx, %eax"); emit(std::string(set) + " %al"); emit("movzbl %al, %eax");
+        }
+    }
+
+    void gen(const Expr& e){
+        switch(e.kind){
+            case Expr::Number: case Expr::Character: case Expr::Boolean:
+                emit("movl $" + std::to_string(e.intValue) + ", %eax"); break;
+            case Expr::Real:
+                emit("movsd " + doubleConstant(e.realValue) + "(%rip), %xmm0"); break;
+            case Expr::Text: unsupported(e.line, "a string value");
+            case Expr::Variable: load(e.type, slot(e.var)); break;
+            case Expr::Index: address(e); load(e.type, "(%rsi)"); break;
+            case Expr::Cast: gen(*e.args[0]); convert(e.args[0]->type, e.type); break;
+            case Expr::Unary: {
+                const Expr& a = *e.args[0];
+                gen(a);
+                if(e.op=="!"){ convert(a.type, ValueType::Bool); emit("xorl $1, %eax"); }
+                else if(isDouble(e.type)){ if(e.op=="-"){ emit("movq %xmm0, %rax"); emit("btcq $63, %rax"); emit("movq %rax, %xmm0"); } }
+                else if(e.op=="-") emit("negl %eax");
+                break;
+            }
+            case Expr::Logical: {
+                std::string shortCut = label(), done = label();
+                bool isAnd = e.op=="&&";
+                gen(*e.args[0]); convert(e.args[0]->type, ValueType::Bool);
+                emit("testl %eax, %eax"); emit(std::string(isAnd ? "je " : "jne ") + shortCut);
+                gen(*e.args[1]); convert(e.args[1]->type, ValueType::Bool);
+                emit("jmp " + done);
+                text << shortCut << ":\n";
+                emit(isAnd ? "xorl %eax, %eax" : "movl $1, %eax");
+                text << done << ":\n";
+                break;
+            }
+            case Expr::Binary: {
+                if(e.type==ValueType::String || e.args[0]->type==ValueType::String || e.args[1]->type==ValueType::String) unsupported(e.line, "a string operation");
+                ValueType t = arithmeticType(e.args[0]->type, e.args[1]->type);
+                gen(*e.args[0]); convert(e.args[0]->type, t); push(t);
+                gen(*e.args[1]); convert(e.args[1]->type, t);
+                if(isDouble(t)) emit("movapd %xmm0, %xmm1"); else emit("movl %eax, %ecx");
+                if(isDouble(t)){ emit("movsd (%rsp), %xmm0"); emit("addq $8, %rsp"); } else emit("popq %rax");
+                arithmetic(e.op, t);
+                break;
+            }
+            case Expr::Assign: {
+                const Expr& target = *e.args[0]; const Expr& value = *e.args[1];
+                if(target.type==ValueType::String) unsupported(e.line, "a string assignment");
+                // The right operand is sequenced before the target, as in C++17
+                std::string op = e.op.substr(0, e.op.size()-1);
+                ValueType t = op.empty() ? target.type : arithmeticType(target.type, value.type);
+                gen(value); convert(value.type, t); push(t);
+                address(target);
+                popSecond(t);
+                if(op.empty()){ if(isDouble(t)) emit("movapd %xmm1, %xmm0"); else emit("movl %ecx, %eax"); }
+                else { load(target.type, "(%rsi)"); convert(target.type, t); arithmetic(op, t); convert(t, target.type); }
+                store(target.type, "(%rsi)");
+                break;
+            }
+            case Expr::Step: {
+                const Expr& target = *e.args[0];
+                address(target);
+                load(target.type, "(%rsi)");
+                std::string delta = e.op=="++" ? "1" : "-1";
+                if(isDouble(target.type)){
+                    emit("movsd %xmm0, %xmm2");
+                    emit("movsd " + doubleConstant(e.op=="++" ? 1.0 : -1.0) + "(%rip), %xmm1");
+                    emit("addsd %xmm1, %xmm0");
+                    store(target.type, "(%rsi)");
+                    if(e.postfix) emit("movsd %xmm2, %xmm0");
+                } else {
+                    emit("movl %eax, %edx");
+                    emit("addl $" + delta + ", %eax");
+                    convert(ValueType::Int, target.type);
+                    store(target.type, "(%rsi)");
+                    if(e.postfix) emit("movl %edx, %eax");
+                }
+                break;
+            }
+        }
+    }
+
+    void branchIfFalse(const Expr& cond, const std::string& target){
+        gen(cond); convert(cond.type, ValueType::Bool);
+        emit("testl %eax, %eax"); emit("je " + target);
+    }
+
+    void openScope(){ cleanups.emplace_back(); }
+    void closeScope(){
+        for(auto it=cleanups.back().rbegin(); it!=cleanups.back().rend(); ++it){ emit("movq " + slot(*it) + ", %rdi"); emit("call free"); }
+        cleanups.pop_back();
+    }
+    // Bodies of jodi/loop are scopes of their own, so their arrays are released each pass
+    void body(const Stmt& s){ openScope(); genStmt(s); closeScope(); }
+
+    void genStmt(const Stmt& s){
+        switch(s.kind){
+            case Stmt::Block:
+                if(s.scoped){ openScope(); for(auto& b: s.body) genStmt(*b); closeScope(); }
+                else for(auto& b: s.body) genStmt(*b);
+                break;
+            case Stmt::Declare: {
+                ValueType t = s.var->type;
+                if(t==ValueType::String) unsupported(s.line, "lekha");
+                if(s.var->isArray){
+                    gen(*s.size); convert(s.size->type, ValueType::Int);
+                    emit("movslq %eax, %rdi"); emit("movl $" + std::to_string(elementSize(t)) + ", %esi");
+                    emit("call bg_alloc_array"); emit("movq %rax, " + slot(s.var));
+                    if(!cleanups.empty()) cleanups.back().push_back(s.var);
+                    for(size_t i=0;i<s.initList.size();++i){
+                        gen(*s.initList[i]); convert(s.initList[i]->type, t);
+                        emit("movq " + slot(s.var) + ", %rsi");
+                        store(t, std::to_string(i*elementSize(t)) + "(%rsi)");
+                    }
+                } else if(s.init){
+                    gen(*s.init); convert(s.init->type, t); store(t, slot(s.var));
+                } else emit("movq $0, " + slot(s.var));
+                break;
+            }
+            case Stmt::Read: {
+                const Expr& target = *s.target;
+                const char* fn = target.type==ValueType::Int ? "bg_read_int" : target.type==ValueType::Double ? "bg_read_double"
+                               : target.type==ValueType::Char ? "bg_read_char" : target.type==ValueType::Bool ? "bg_read_bool" : nullptr;
+                if(!fn) unsupported(s.line, "poro into lekha");
+                address(target); emit("movq %rsi, %rdi"); emit(std::string("call ") + fn);
+                break;
+            }
+            case Stmt::Print:
+                for(auto& p: s.parts){
+                    if(p.isText){ emit("leaq " + stringConstant(p.text) + "(%rip), %rdi"); emit("call bg_print_str"); continue; }
+                    const Expr& e = *p.expr;
+                    if(e.kind==Expr::Text){ emit("leaq " + stringConstant(e.text) + "(%rip), %rdi"); emit("call bg_print_str"); continue; }
+                    gen(e);
+                    if(isDouble(e.type)) emit("call bg_print_double");
+                    else if(e.type==ValueType::Char){ emit("movl %eax, %edi"); emit("call bg_print_char"); }
+                    else if(e.type==ValueType::Int || e.type==ValueType::Bool){ emit("movl %eax, %edi"); emit("call bg_print_int"); }
+                    else unsupported(s.line, "printing a string value");
+                }
+                break;
+            case Stmt::If: {
+                std::string otherwise = label(), done = label();
+                branchIfFalse(*s.cond, otherwise);
+                body(*s.then);
+                emit("jmp " + done);
+                text << otherwise << ":\n";
+                if(s.otherwise) body(*s.otherwise);
+                text << done << ":\n";
+                break;
+            }
+            case Stmt::Loop: {
+                std::string top = label(), done = label();
+                openScope();
+                if(s.start) genStmt(*s.start);
+                text << top << ":\n";
+                if(s.cond) branchIfFalse(*s.cond, done);
+                body(*s.then);
+                if(s.step) gen(*s.step);
+                emit("jmp " + top);
+                text << done << ":\n";
+                closeScope();
+                break;
+            }
+            case Stmt::Return:
+                gen(*s.value); convert(s.value->type, ValueType::Int);
+                emit("movl %eax, %edi"); emit("call bg_exit");
+                break;
+            case Stmt::Eval:
+                if(s.value->kind==Expr::Text) unsupported(s.line, "a string value");
+                gen(*s.value);
+                break;
+        }
+    }
+
+public:
+    // Returns the whole assembly file; throws LoweringError for constructs outside the native subset
+    std::string generate(const Program& program){
+        size_t frame = (program.vars.size()*8 + 15) & ~size_t(15);
+        for(auto& s: program.body) genStmt(*s);
+        std::ostringstream out;
+        out << "\t.text\n\t.globl main\n\t.type main, @function\nmain:\n"
+            << "\tpushq %rbp\n\tmovq %rsp, %rbp\n";
+        if(frame) out << "\tsubq $" << frame << ", %rsp\n";
+        out << text.str()
+            << "\txorl %edi, %edi\n\tcall bg_exit\n"
+            << "\t.size main, .-main\n"
+            << "\t.section .rodata\n" << rodata.str()
+            << "\t.section .note.GNU-stack,\"\",@progbits\n";
+        return out.str();
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "token.h"
+
+// Owns the source bytes, a line-offset index and the token array; every phase borrows from it
+struct CompilationUnit {
+    std::string source;
+    std::vector<size_t> lineStarts; // Byte offset where each line begins
+    std::vector<Token> tokens;
+    bool ascii = true;              // No multi-byte UTF-8, so token columns are byte offsets
+
+    explicit CompilationUnit(std::string src) : source(std::move(src)) { indexLines(); }
+    CompilationUnit(const CompilationUnit&) = delete;
+    CompilationUnit& operator=(const CompilationUnit&) = delete;
+
+    void indexLines(){
+        lineStarts.clear();
+        ascii = true;
+        if(source.empty()) return;
+        lineStarts.push_back(0);
+        for(size_t i=0;i<source.size();++i){
+            if(source[i]=='\n' && i+1<source.size()) lineStarts.push_back(i+1);
+            ascii &= (unsigned char)source[i] < 0x80;
+        }
+    }
+    size_t lineCount() const { return lineStarts.size(); }
+    // Byte offset of a 1-based (line, col) token position; col counts code points
+    size_t offsetOf(int line, int col) const {
+        size_t at = line>=1 && (size_t)line<=lineStarts.size() ? lineStarts[line-1] : source.size();
+        if(ascii) return at + col - 1;
+        for(int c=1; at<source.size(); ++at){
+            if(((unsigned char)source[at] & 0xC0)!=0x80 && c++==col) break;
+        }
+        return at;
+    }
+    // Line i (0-based) without its terminating '\n', same split as std::getline
+    std::string_view line(size_t i) const {
+        size_t a = lineStarts[i];
+        size_t b = i+1<lineStarts.size() ? lineStarts[i+1]-1 : source.size();
+        if(b>a && i+1==lineStarts.size() && source[b-1]=='\n') b--;
+        return std::string_view(source).substr(a, b-a);
+    }
+};
+
+inline std::string_view trim_view(std::string_view s){
+    size_t a=s.find_first_not_of(" \t\r\n"); if(a==std::string_view::npos) return {};
+    size_t b=s.find_last_not_of(" \t\r\n"); return s.substr(a,b-a+1);
+}
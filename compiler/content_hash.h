@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Content hashes behind the on-disk caches (.bgc stamps, PGO profiles, banglishd binaries, bench baselines)
+// and the specializer's input check. Stable across builds and platforms, so cached names survive a rebuild.
+namespace bg {
+
+// 64-bit FNV-1a; `hash` continues an earlier call over a prefix
+inline uint64_t fnv1a(std::string_view data, uint64_t hash = 1469598103934665603ull){
+    for(unsigned char c: data){ hash ^= c; hash *= 1099511628211ull; }
+    return hash;
+}
+
+// 16 lowercase hex digits, the form hashes take in file names and baselines
+inline std::string hexName(uint64_t hash){
+    std::string name(16, '0');
+    for(int i = 15; i >= 0; --i, hash >>= 4) name[i] = "0123456789abcdef"[hash & 15];
+    return name;
+}
+
+} // namespace bg
@@ -0,0 +1,42 @@
+#pragma once
+#include "compilation_unit.h"
+#include "lexer.h"
+#include "parser.h"
+#include "validator.h"
+
+// Fused front end: one forward sweep over the source lexes each line, runs the parser's per-token
+// checks, the brace/paren/bracket balance and the validator's token checks on the tokens as they
+// appear, and classifies the line once its bytes are consumed. Statement syntax is then checked on
+// the finished token array. error_log.txt and output_validation.txt match the phase-by-phase run.
+inline void runFusedFrontEnd(CompilationUnit& unit, ErrorLogger& logger, bg::ValidationReport& report) {
+    Lexer lexer(unit.source);
+    BanglishParser parser(lexer.tokens, logger);
+    ErrorLogger structureLog("");  // Structure errors follow every per-token error in the log
+    BanglishParser::StructureState structure;
+    bg::TokenValidator tokenValidator;
+    bg::LineValidator lineValidator;
+
+    size_t seen = 0;
+    auto drain = [&]() {
+        for (; seen < lexer.tokens.size(); ++seen) {
+            const Token& token = lexer.tokens[seen];
+            parser.checkToken(token);
+            parser.checkStructure(token, structure, structureLog);
+            tokenValidator.check(token, report.tokenErrors);
+        }
+    };
+    for (size_t li = 0; li < unit.lineCount(); ++li) {
+        size_t lineEnd = li + 1 < unit.lineCount() ? unit.lineStarts[li + 1] : unit.source.size();
+        while ((size_t)lexer.i < lineEnd && lexer.next()) {}
+        drain();
+        lineValidator.check((int)li + 1, unit.line(li), report.lineErrors);
+    }
+    while (lexer.next()) {}
+    lexer.finish();
+    drain();
+
+    parser.finishStructure(structure, structureLog);
+    logger.append(structureLog);
+    parser.validateStatementSyntax();
+    unit.tokens = std::move(lexer.tokens);
+}
@@ -0,0 +1,315 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ast.h"
+
+// Raised where the compiled program would hit undefined behaviour (overflow, division by zero,
+// out-of-range index or conversion). The interpreter cannot promise the same result, so the
+// caller hands the run to the compiled binary instead.
+struct InterpreterError : std::runtime_error {
+    int line;
+    InterpreterError(int l, const std::string& msg) : std::runtime_error("line " + std::to_string(l) + ": " + msg), line(l) {}
+};
+
+// Tree-walking interpreter for a typed Program. Reads and writes go through real iostreams so
+// `poro` and `dekhao` behave exactly like the transpiled C++.
+class Interpreter {
+public:
+    std::function<void()> checkpoint;   // Called every few thousand steps; may throw to abandon the run
+    size_t checkpointEvery = 4096;
+
+    Interpreter(const Program& p, std::istream& input, std::ostream& output) : program(p), in(input), out(output), cells(p.vars.size()) {}
+
+    // Runs the program and returns its `ferot dao` code (0 when it falls off the end)
+    int run(){
+        try { for(auto& s: program.body) exec(*s); }
+        catch(const ProgramExit& e){ return e.code; }
+        return 0;
+    }
+
+    // Runs one more statement on the values earlier ones left behind, with cells for anything declared since
+    // (the REPL). Returns true when it executed `ferot dao`, with the code in `code`.
+    bool execute(const Stmt& s, int& code){
+        if(cells.size() < program.vars.size()) cells.resize(program.vars.size());
+        try { exec(s); }
+        catch(const ProgramExit& e){ code = e.code; return true; }
+        return false;
+    }
+    // Current value as dekhao prints it; arrays as {a, b, ...} with the first few elements
+    std::string describe(const VarInfo& var) const {
+        if((size_t)var.id >= cells.size()) return "";
+        const Cell& c = cells[var.id];
+        std::ostringstream text;
+        auto scalar = [&](long long i, double d, const std::string& s){
+            switch(var.type){
+                case ValueType::Double: text << d; break;
+                case ValueType::Char: text << '\'' << (char)i << '\''; break;
+                case ValueType::Bool: text << (i != 0); break;
+                case ValueType::String: text << '"' << s << '"'; break;
+                default: text << (int)i;
+            }
+        };
+        if(!var.isArray){ scalar(c.i, c.d, c.s); return text.str(); }
+        size_t n = length(var), shown = std::min(n, (size_t)8);
+        text << '{';
+        for(size_t k=0;k<shown;++k){
+            if(k) text << ", ";
+            scalar(k < c.ints.size() ? c.ints[k] : 0, k < c.reals.size() ? c.reals[k] : 0, k < c.texts.size() ? c.texts[k] : std::string());
+        }
+        if(n > shown) text << ", ... " << n - shown << " more";
+        text << '}';
+        return text.str();
+    }
+    size_t length(const VarInfo& var) const {
+        if((size_t)var.id >= cells.size()) return 0;
+        const Cell& c = cells[var.id];
+        return var.type==ValueType::Double ? c.reals.size() : var.type==ValueType::String ? c.texts.size() : c.ints.size();
+    }
+
+private:
+    struct ProgramExit { int code; };
+    struct Value { long long i = 0; double d = 0; };    // Int/Char/Bool use i, Double uses d
+    struct Cell {
+        long long i = 0; double d = 0; std::string s;
+        std::vector<long long> ints; std::vector<double> reals; std::vector<std::string> texts;
+    };
+
+    const Program& program;
+    std::istream& in;
+    std::ostream& out;
+    std::vector<Cell> cells;
+    size_t steps = 0;
+
+    [[noreturn]] static void fault(const Expr& e, const char* what){ throw InterpreterError(e.line, what); }
+    void tick(){ if(++steps % checkpointEvery == 0 && checkpoint) checkpoint(); }
+
+    static long long narrow(ValueType t, long long v){
+        if(t==ValueType::Char) return (signed char)v;
+        if(t==ValueType::Bool) return v != 0;
+        return v;
+    }
+    static Value convert(const Expr& at, Value v, ValueType from, ValueType to){
+        if(to==ValueType::Double){ if(from!=ValueType::Double) v.d = (double)v.i; return v; }
+        if(from==ValueType::Double){
+            if(to==ValueType::Bool){ v.i = v.d != 0 || std::isnan(v.d); return v; }
+            double lo = to==ValueType::Char ? SCHAR_MIN : INT_MIN, hi = to==ValueType::Char ? SCHAR_MAX : INT_MAX;
+            if(!(v.d > lo - 1 && v.d < hi + 1)) fault(at, "double out of range for conversion");
+            v.i = (long long)v.d; return v;
+        }
+        v.i = narrow(to, v.i);
+        return v;
+    }
+    static long long checkedInt(const Expr& e, long long v){
+        if(v < INT_MIN || v > INT_MAX) fault(e, "integer overflow");
+        return v;
+    }
+    Value arithmetic(const Expr& at, const std::string& op, Value a, Value b, ValueType t){
+        Value r;
+        if(t==ValueType::Double){
+            if(op=="+") r.d = a.d + b.d; else if(op=="-") r.d = a.d - b.d;
+            else if(op=="*") r.d = a.d * b.d; else if(op=="/") r.d = a.d / b.d;
+            else if(op=="<") r.i = a.d < b.d; else if(op=="<=") r.i = a.d <= b.d;
+            else if(op==">") r.i = a.d > b.d; else if(op==">=") r.i = a.d >= b.d;
+            else if(op=="==") r.i = a.d == b.d; else r.i = a.d != b.d;
+            return r;
+        }
+        if(op=="+") r.i = checkedInt(at, a.i + b.i); else if(op=="-") r.i = checkedInt(at, a.i - b.i);
+        else if(op=="*") r.i = checkedInt(at, a.i * b.i);
+        else if(op=="/" || op=="%"){
+            if(b.i==0) fault(at, "division by zero");
+            if(a.i==INT_MIN && b.i==-1) fault(at, "integer overflow");
+            r.i = op=="/" ? a.i / b.i : a.i % b.i;
+        }
+        else if(op=="&") r.i = a.i & b.i; else if(op=="|") r.i = a.i | b.i;
+        else if(op=="<") r.i = a.i < b.i; else if(op=="<=") r.i = a.i <= b.i;
+        else if(op==">") r.i = a.i > b.i; else if(op==">=") r.i = a.i >= b.i;
+        else if(op=="==") r.i = a.i == b.i; else r.i = a.i != b.i;
+        return r;
+    }
+
+    size_t index(const Expr& e){
+        Value v = eval(*e.args[0]);
+        Cell& c = cells[e.var->id];
+        size_t n = e.var->type==ValueType::Double ? c.reals.size() : e.var->type==ValueType::String ? c.texts.size() : c.ints.size();
+        if(v.i < 0 || (size_t)v.i >= n) fault(e, "array index out of range");
+        return (size_t)v.i;
+    }
+    Value load(const Expr& e){
+        Cell& c = cells[e.var->id];
+        Value v;
+        if(e.kind==Expr::Variable){ v.i = c.i; v.d = c.d; return v; }
+        size_t k = index(e);
+        if(e.type==ValueType::Double) v.d = c.reals[k]; else v.i = c.ints[k];
+        return v;
+    }
+    void store(const Expr& e, Value v){
+        Cell& c = cells[e.var->id];
+        if(e.kind==Expr::Variable){ if(e.type==ValueType::Double) c.d = v.d; else c.i = v.i; return; }
+        size_t k = index(e);
+        if(e.type==ValueType::Double) c.reals[k] = v.d; else c.ints[k] = v.i;
+    }
+    std::string& text(const Expr& e){
+        Cell& c = cells[e.var->id];
+        return e.kind==Expr::Variable ? c.s : c.texts[index(e)];
+    }
+
+    std::string str(const Expr& e){
+        if(e.type==ValueType::Char) return std::string(1, (char)eval(e).i);
+        switch(e.kind){
+            case Expr::Text: return std::string(e.text.c_str());
+            case Expr::Variable: case Expr::Index: return text(e);
+            case Expr::Binary: return str(*e.args[0]) + str(*e.args[1]);
+            case Expr::Assign: {
+                std::string v = str(*e.args[1]);
+                std::string& target = text(*e.args[0]);
+                if(e.op=="=") target = v; else target += v;
+                return target;
+            }
+            default: fault(e, "unsupported string expression");
+        }
+    }
+
+    Value eval(const Expr& e){
+        Value v;
+        switch(e.kind){
+            case Expr::Number: case Expr::Character: case Expr::Boolean: v.i = e.intValue; return v;
+            case Expr::Real: v.d = e.realValue; return v;
+            case Expr::Text: fault(e, "string used as a number");
+            case Expr::Variable: case Expr::Index: return load(e);
+            case Expr::Cast: return convert(e, eval(*e.args[0]), e.args[0]->type, e.castTo);
+            case Expr::Unary: {
+                const Expr& a = *e.args[0];
+                Value x = eval(a);
+                if(e.op=="!"){ v.i = !convert(a, x, a.type, ValueType::Bool).i; return v; }
+                if(e.type==ValueType::Double){ v.d = e.op=="-" ? -x.d : x.d; return v; }
+                v.i = e.op=="-" ? checkedInt(e, -x.i) : x.i; return v;
+            }
+            case Expr::Logical: {
+                bool lhs = convert(*e.args[0], eval(*e.args[0]), e.args[0]->type, ValueType::Bool).i;
+                if(e.op=="&&" ? !lhs : lhs){ v.i = lhs; return v; }
+                v.i = convert(*e.args[1], eval(*e.args[1]), e.args[1]->type, ValueType::Bool).i;
+                return v;
+            }
+            case Expr::Binary: {
+                const Expr& a = *e.args[0]; const Expr& b = *e.args[1];
+                if(a.type==ValueType::String || b.type==ValueType::String){
+                    int c = str(a).compare(str(b));
+                    const std::string& op = e.op;
+                    v.i = op=="==" ? c==0 : op=="!=" ? c!=0 : op=="<" ? c<0 : op=="<=" ? c<=0 : op==">" ? c>0 : c>=0;
+                    return v;
+                }
+                ValueType t = arithmeticType(a.type, b.type);
+                Value x = convert(a, eval(a), a.type, t);
+                Value y = convert(b, eval(b), b.type, t);
+                return arithmetic(e, e.op, x, y, t);
+            }
+            case Expr::Assign: {
+                const Expr& target = *e.args[0]; const Expr& value = *e.args[1];
+                if(target.type==ValueType::String){ str(e); return v; }
+                std::string op = e.op.substr(0, e.op.size()-1);
+                if(op.empty()){
+                    Value x = convert(value, eval(value), value.type, target.type);
+                    store(target, x); return x;
+                }
+                ValueType t = arithmeticType(target.type, value.type);
+                Value y = convert(value, eval(value), value.type, t);
+                Value x = convert(target, load(target), target.type, t);
+                Value r = convert(e, arithmetic(e, op, x, y, t), t, target.type);
+                store(target, r); return r;
+            }
+            case Expr::Step: {
+                const Expr& target = *e.args[0];
+                Value old = load(target), now = old;
+                if(target.type==ValueType::Double) now.d += e.op=="++" ? 1 : -1;
+                else {
+                    now.i += e.op=="++" ? 1 : -1;
+                    now.i = target.type==ValueType::Int ? checkedInt(e, now.i) : narrow(target.type, now.i);
+                }
+                store(target, now);
+                return e.postfix ? old : now;
+            }
+        }
+        return v;
+    }
+
+    void print(const Expr& e){
+        if(e.kind==Expr::Text){ out << e.text.c_str(); return; }
+        if(e.type==ValueType::String){ out << str(e); return; }
+        Value v = eval(e);
+        switch(e.type){
+            case ValueType::Double: out << v.d; break;
+            case ValueType::Char: out << (char)v.i; break;
+            case ValueType::Bool: out << (bool)v.i; break;
+            default: out << (int)v.i;
+        }
+    }
+
+    void read(const Expr& target){
+        switch(target.type){
+            case ValueType::String: std::getline(in >> std::ws, text(target)); return;
+            case ValueType::Double: { Value v = load(target); in >> v.d; store(target, v); return; }
+            case ValueType::Char: { Value v = load(target); char c = (char)v.i; in >> c; v.i = c; store(target, v); return; }
+            case ValueType::Bool: { Value v = load(target); bool b = v.i; in >> b; v.i = b; store(target, v); return; }
+            default: { Value v = load(target); int x = (int)v.i; in >> x; v.i = x; store(target, v); return; }
+        }
+    }
+
+    void declare(const Stmt& s){
+        const VarInfo& var = *s.var;
+        Cell& c = cells[var.id];
+        if(!var.isArray){
+            if(var.type==ValueType::String) c.s = s.init ? str(*s.init) : std::string();
+            else {
+                Value v = s.init ? convert(*s.init, eval(*s.init), s.init->type, var.type) : Value();
+                c.i = v.i; c.d = v.d;
+            }
+            return;
+        }
+        long long n = eval(*s.size).i;
+        if(n < 0 || n > (1LL << 28) || (long long)s.initList.size() > n) fault(*s.size, "unsupported array size");
+        if(var.type==ValueType::String){
+            c.texts.assign((size_t)n, std::string());
+            for(size_t k=0;k<s.initList.size();++k) c.texts[k] = str(*s.initList[k]);
+        } else if(var.type==ValueType::Double){
+            c.reals.assign((size_t)n, 0.0);
+            for(size_t k=0;k<s.initList.size();++k) c.reals[k] = convert(*s.initList[k], eval(*s.initList[k]), s.initList[k]->type, ValueType::Double).d;
+        } else {
+            c.ints.assign((size_t)n, 0);
+            for(size_t k=0;k<s.initList.size();++k) c.ints[k] = convert(*s.initList[k], eval(*s.initList[k]), s.initList[k]->type, var.type).i;
+        }
+    }
+
+    bool truth(const Expr& e){ return convert(e, eval(e), e.type, ValueType::Bool).i; }
+
+    void exec(const Stmt& s){
+        tick();
+        switch(s.kind){
+            case Stmt::Block: for(auto& b: s.body) exec(*b); break;
+            case Stmt::Declare: declare(s); break;
+            case Stmt::Read: read(*s.target); break;
+            case Stmt::Print: for(auto& p: s.parts){ if(p.isText) out << p.text.c_str(); else print(*p.expr); } break;
+            case Stmt::If:
+                if(truth(*s.cond)) exec(*s.then);
+                else if(s.otherwise) exec(*s.otherwise);
+                break;
+            case Stmt::Loop:
+                if(s.start) exec(*s.start);
+                while(!s.cond || truth(*s.cond)){
+                    exec(*s.then);
+                    if(s.step) eval(*s.step);
+                }
+                break;
+            case Stmt::Return: throw ProgramExit{(int)convert(*s.value, eval(*s.value), s.value->type, ValueType::Int).i};
+            case Stmt::Eval:
+                if(s.value->type==ValueType::String) str(*s.value); else eval(*s.value);
+                break;
+        }
+    }
+};
@@ -1,9 +1,11 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <set>
 #include <cctype>
 #include "token.h"
+#include "utf8.h"
 
 static const std::set<std::string> BG_KEYWORDS = {
     "shuru","shesh","purno","sonkha","dosomik","lekha","akkhor","sotto-mittha",
@@ -17,99 +19,158 @@ static const std::set<std::string> BG_SIMPLE_OPS = {
     "(",")","{","}",";","," 
 };
 
+// Bit tables over BG_SIMPLE_OPS so operator lookup costs no string construction
+struct SimpleOpTable {
+    std::vector<bool> two = std::vector<bool>(256*256);
+    SimpleOpTable(){
+        for(const auto& op: BG_SIMPLE_OPS){
+            if(op.size()==2) two[(unsigned char)op[0]*256 + (unsigned char)op[1]] = true;
+        }
+    }
+    static const SimpleOpTable& get(){ static const SimpleOpTable table; return table; }
+};
+
+// Source is UTF-8: identifiers may use Bengali script, strings and comments may hold any text, and
+// columns count code points. Malformed bytes become INVALID_UTF8 error tokens.
 struct Lexer {
-    std::string src; std::vector<Token> tokens; int i=0; int line=1; int col=1;
-    Lexer(const std::string&s):src(s){}
+    std::string_view src; std::vector<Token> tokens; int i=0; int line=1; int col=1;
+    bool utf8Valid;   // Whole input checked up front; only a malformed one needs per-sequence checks
+    int badLine=0, badCol=0, checkedUntil=0;
+    Lexer(std::string_view s):src(s),utf8Valid(bg::utf8::valid(s)){}
 
     char peek(int k=0){ if(i+k<(int)src.size()) return src[i+k]; return '\0'; }
-    char get(){ char c=peek(); if(c=='\n'){ line++; col=1; } else col++; i++; return c; }
-    void add(const std::string&type,const std::string&lex,int l,int c){ tokens.push_back({type,lex,l,c}); }
+    char at(int j) const { return j<(int)src.size() ? src[j] : '\0'; }
+    // Continuation bytes do not move the column
+    char get(){ char c=peek(); if(c=='\n'){ line++; col=1; } else if(((unsigned char)c & 0xC0)!=0x80) col++; i++; return c; }
+    void add(const char* type,std::string lex,int l,int c){ tokens.push_back({type,std::move(lex),l,c}); }
+    const char* end() const { return src.data()+src.size(); }
 
-    static bool isIdentStart(char c){ return isalpha((unsigned char)c) || c=='_'; }
-    static bool isIdentChar(char c){ return isalnum((unsigned char)c) || c=='_'; }
+    int identStart(int j) const { return j<(int)src.size() ? bg::utf8::identStartLength(src.data()+j, end()) : 0; }
+    int identChar(int j) const { return j<(int)src.size() ? bg::utf8::identCharLength(src.data()+j, end()) : 0; }
+    // In a string or comment of a malformed input: remembers where the first bad byte was
+    void checkText(){
+        if(utf8Valid || (unsigned char)peek()<0x80 || badLine || i<checkedUntil) return;
+        char32_t cp; int n=bg::utf8::decode(src.data()+i, end(), cp);
+        if(n) checkedUntil=i+n;
+        else { badLine=line; badCol=col; }
+    }
+    void flushInvalid(){
+        if(badLine) add("ERROR","INVALID_UTF8",badLine,badCol);
+        badLine=0;
+    }
 
-    void lex(){
-        while(true){
-            char c=peek(); if(c=='\0') break;
-            if(isspace((unsigned char)c)){ get(); continue; }
-            int l=line, c0=col;
-            if(c=='/' && peek(1)=='/') { while(peek()!='\n' && peek()!='\0') get(); continue; }
-            if(c=='"'){
-                get(); std::string val; bool terminated = false;
-                while(true){ 
-                    char d=peek(); 
-                    if(d=='\0' || d=='\n') { 
-                        break; 
-                    }
-                    if(d=='\\'){ 
-                        get(); 
-                        char e=get(); 
-                        if(e != '\0') {
-                            val.push_back('\\'); 
-                            val.push_back(e); 
-                        }
-                    }
-                    else if(d=='"'){ 
-                        get(); 
-                        terminated = true;
-                        break; 
-                    }
-                    else { 
-                        val.push_back(get()); 
+    // Consumes one token (or a run of blanks / a comment); false once the input is exhausted
+    bool next(){
+        char c=peek(); if(c=='\0') return false;
+        if(isspace((unsigned char)c)){
+            while(true){
+                size_t n=bg::utf8::blankRun(src.data()+i, end()); i+=(int)n; col+=(int)n;
+                if(!isspace((unsigned char)peek())) break;
+                get();
+            }
+            return true;
+        }
+        int l=line, c0=col;
+        if(c=='/' && peek(1)=='/') { while(peek()!='\n' && peek()!='\0'){ checkText(); get(); } flushInvalid(); return true; }
+        if(c=='"'){
+            get(); std::string val; bool terminated = false;
+            while(true){ 
+                char d=peek(); 
+                checkText();
+                if(d=='\0' || d=='\n') { 
+                    break; 
+                }
+                if(d=='\\'){ 
+                    get(); 
+                    checkText();
+                    char e=get(); 
+                    if(e != '\0') {
+                        val.push_back('\\'); 
+                        val.push_back(e); 
                     }
                 }
-                if(terminated) {
-                    add("STRING","\""+val+"\"",l,c0); 
-                } else {
-                    add("ERROR","UNCLOSED_STRING",l,c0);
+                else if(d=='"'){ 
+                    get(); 
+                    terminated = true;
+                    break; 
+                }
+                else { 
+                    val.push_back(get()); 
                 }
-                continue;
             }
-            if(isdigit((unsigned char)c)){
-                std::string num; bool hasDot=false;
-                while(isdigit((unsigned char)peek()) || (!hasDot && peek()=='.')){
-                    if(peek()=='.') {
-                        hasDot=true;
-                    }
-                    num.push_back(get());
+            if(terminated) {
+                add("STRING","\""+val+"\"",l,c0); 
+            } else {
+                add("ERROR","UNCLOSED_STRING",l,c0);
+            }
+            flushInvalid();
+            return true;
+        }
+        if(isdigit((unsigned char)c)){
+            std::string num; bool hasDot=false;
+            while(isdigit((unsigned char)peek()) || (!hasDot && peek()=='.')){
+                if(peek()=='.') {
+                    hasDot=true;
+                }
+                num.push_back(get());
+            }
+            add("NUMBER",num,l,c0); return true;
+        }
+        if(int first=identStart(i)){
+            // ASCII stretches are skipped 16 bytes at a time; each Bengali code point is one column
+            int start=i; i+=first; col++;
+            while(true){
+                size_t n=bg::utf8::asciiIdentRun(src.data()+i, end()); i+=(int)n; col+=(int)n;
+                int more=(unsigned char)peek()>=0x80 ? identChar(i) : 0;
+                if(!more) break;
+                i+=more; col++;
+            }
+            std::string id(src.substr(start, i-start));
+            // Only the first word of a two-word keyword needs the lookahead below
+            bool comboHead = id=="purno" || id=="dosomik" || id=="ferot" || id=="nahoy";
+            int j=i; while(comboHead && isspace((unsigned char)at(j)) && at(j)!='\n') j++;
+            if(comboHead && j<(int)src.size() && (isalpha((unsigned char)src[j])||src[j]=='_')){
+                int k=j; std::string id2; id2.push_back(src[k++]);
+                while(k<(int)src.size() && (isalnum((unsigned char)src[k])||src[k]=='_')) id2.push_back(src[k++]);
+                std::string combo = id + std::string(" ") + id2;
+                if(combo=="purno sonkha" || combo=="dosomik sonkha" || combo=="ferot dao" || combo=="nahoy jodi"){
+                    while(i<k) { get(); }
+                    add("KEYWORD",combo,l,c0); return true;
                 }
-                add("NUMBER",num,l,c0); continue;
             }
-            if(isIdentStart(c)){
-                std::string id; id.push_back(get());
-                while(isIdentChar(peek())) id.push_back(get());
-                int j=i; while(isspace((unsigned char)src[j]) && src[j]!='\n') j++;
+            if(id=="sotto" && peek()== '-'){
+                int j=i+1;
                 if(j<(int)src.size() && (isalpha((unsigned char)src[j])||src[j]=='_')){
                     int k=j; std::string id2; id2.push_back(src[k++]);
                     while(k<(int)src.size() && (isalnum((unsigned char)src[k])||src[k]=='_')) id2.push_back(src[k++]);
-                    std::string combo = id + std::string(" ") + id2;
-                    if(combo=="purno sonkha" || combo=="dosomik sonkha" || combo=="ferot dao" || combo=="nahoy jodi"){
+                    std::string combo = id + std::string("-") + id2;
+                    if(combo=="sotto-mittha"){
                         while(i<k) { get(); }
-                        add("KEYWORD",combo,l,c0); continue;
+                        add("KEYWORD",combo,l,c0); return true;
                     }
                 }
-                if(peek()== '-'){
-                    int j=i+1;
-                    if(j<(int)src.size() && (isalpha((unsigned char)src[j])||src[j]=='_')){
-                        int k=j; std::string id2; id2.push_back(src[k++]);
-                        while(k<(int)src.size() && (isalnum((unsigned char)src[k])||src[k]=='_')) id2.push_back(src[k++]);
-                        std::string combo = id + std::string("-") + id2;
-                        if(combo=="sotto-mittha"){
-                            while(i<k) { get(); }
-                            add("KEYWORD",combo,l,c0); continue;
-                        }
-                    }
-                }
-                if(BG_KEYWORDS.count(id)) add("KEYWORD",id,l,c0);
-                else add("IDENT",id,l,c0);
-                continue;
             }
-            std::string two; two.push_back(c); two.push_back(peek(1));
-            if(BG_SIMPLE_OPS.count(two)) { get(); get(); add("OP",two,l,c0); continue; }
-            std::string one; one.push_back(c);
-            if(BG_SIMPLE_OPS.count(one)) { get(); add("OP",one,l,c0); continue; }
-            get(); add("OP",std::string(1,c),l,c0);
+            if(BG_KEYWORDS.count(id)) add("KEYWORD",id,l,c0);
+            else add("IDENT",id,l,c0);
+            return true;
+        }
+        if((unsigned char)c>=0x80){
+            // Any other non-ASCII character is one (invalid) operator token, not one per byte
+            char32_t cp; int n=bg::utf8::decode(src.data()+i, end(), cp);
+            if(!n){ get(); add("ERROR","INVALID_UTF8",l,c0); return true; }
+            i+=n; col++;
+            add("OP",std::string(src.substr(i-n,n)),l,c0); return true;
         }
-        add("EOF","",line,col);
+        const SimpleOpTable& ops = SimpleOpTable::get();
+        char c1=peek(1);
+        if(ops.two[(unsigned char)c*256 + (unsigned char)c1]) { get(); get(); add("OP",std::string{c,c1},l,c0); return true; }
+        get(); add("OP",std::string(1,c),l,c0);
+        return true;
+    }
+    void finish(){ add("EOF","",line,col); }
+
+    void lex(){
+        while(next()){}
+        finish();
     }
 };
@@ -0,0 +1,113 @@
+#pragma once
+#include <sstream>
+#include <string>
+#include <vector>
+#include "compilation_unit.h"
+#include "lexer.h"
+#include "parser.h"
+#include "validator.h"
+#include "frontend.h"
+#include "transpiler.h"
+#include "ast.h"
+#include "interpreter.h"
+
+// In-process compiler API: the driver's front end and C++ emitter without any fixed file names.
+// Every call owns its state, so compile() is reentrant and may run on many threads at once.
+namespace bg {
+
+struct CompileOptions {
+    bool fused = false;         // Single-sweep front end, same diagnostics as the phase-by-phase one
+    bool useArena = false;      // Generated C++ as with --arena
+    bool lineMap = false;       // #line directives back to sourceName
+    bool profileLines = false;  // Per-line counters in the generated C++
+    std::string sourceName = "main.banglish";
+    bool execute = false;       // Run the program in the interpreter on `input`
+    std::string input;
+    size_t maxSteps = 50000000; // Execution budget in interpreter steps; 0 means unlimited
+};
+
+struct ExecutionResult {
+    bool ran = false;           // False when the program could not be run in process (see error)
+    bool lowered = false;       // The interpreter took the program; if it still did not run, it hit the budget or a fault
+    int exitCode = 0;           // `ferot dao` value
+    std::string output;         // What `dekhao` wrote
+    std::string error;
+};
+
+struct CompileResult {
+    std::vector<Token> tokens;
+    std::vector<ParseError> errors;     // As listed in errorLog: one per type and symbol, at most ErrorLogger::DETAIL_LIMIT
+    std::vector<ParseError> warnings;
+    size_t errorCount = 0;              // Everything found, including repeats and suppressed entries
+    size_t warningCount = 0;
+    std::string errorLog;       // Same text the driver writes to error_log.txt
+    ValidationReport validation;
+    std::vector<Symbol> symbols;
+    std::string cpp;            // Same code the driver writes to .generated/transpiled.cpp
+    ExecutionResult execution;
+    bool ok() const { return errors.empty(); }
+};
+
+inline CompileResult compile(const std::string& source, const CompileOptions& options = {}){
+    CompileResult result;
+    CompilationUnit unit(source);
+    ErrorLogger logger("");
+    if(options.fused){
+        runFusedFrontEnd(unit, logger, result.validation);
+    } else {
+        Lexer lexer(unit.source);
+        lexer.lex();
+        unit.tokens = std::move(lexer.tokens);
+        BanglishParser parser(unit.tokens, logger);
+        parser.parse();
+        result.validation.tokenErrors = validateTokens(unit.tokens);
+        result.validation.lineErrors = validateLines(unit);
+    }
+    result.errors = logger.getErrors();
+    result.warnings = logger.getWarnings();
+    result.errorCount = logger.getErrorCount();
+    result.warningCount = logger.getWarningCount();
+    std::ostringstream log;
+    logger.writeLog(log);
+    result.errorLog = log.str();
+
+    Transpiler transpiler;
+    transpiler.useArena = options.useArena;
+    transpiler.lineMap = options.lineMap;
+    transpiler.profileLines = options.profileLines;
+    transpiler.sourceName = options.sourceName;
+    result.cpp = transpiler.transpile(unit);
+    result.symbols = transpiler.sym.all();
+
+    if(options.execute){
+        ExecutionResult& run = result.execution;
+        struct OutOfSteps {};
+        try {
+            Program program;
+            buildProgram(unit, program);
+            run.lowered = true;
+            std::istringstream in(options.input);
+            std::ostringstream out;
+            Interpreter interpreter(program, in, out);
+            size_t steps = 0;
+            if(options.maxSteps) interpreter.checkpoint = [&]{
+                if((steps += interpreter.checkpointEvery) >= options.maxSteps) throw OutOfSteps{};
+            };
+            try {
+                run.exitCode = interpreter.run();
+                run.ran = true;
+            } catch(const OutOfSteps&){
+                run.error = "execution budget of " + std::to_string(options.maxSteps) + " steps exhausted";
+            } catch(const InterpreterError& e){
+                run.error = std::string("undefined behaviour at ") + e.what();
+            }
+            run.output = out.str();
+        } catch(const LoweringError& e){
+            run.error = std::string("cannot run in process: ") + e.what();
+        }
+    }
+    result.tokens = std::move(unit.tokens);
+    return result;
+}
+
+} // namespace bg
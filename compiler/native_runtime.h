@@ -0,0 +1,153 @@
+#pragma once
+
+// Runtime linked into native and C programs. Reads follow std::cin's rules: running out of input leaves
+// the target untouched, malformed input zeroes it, and every read after a failure is skipped.
+// Doubles print like std::cout's default "%g".
+static const char* BG_NATIVE_RUNTIME = R"(#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+
+static char bg_in[1 << 16]; static size_t bg_in_len, bg_in_pos; static int bg_in_eof, bg_failed;
+static char bg_out[1 << 16]; static size_t bg_out_len;
+
+static void bg_flush(void){ fwrite(bg_out, 1, bg_out_len, stdout); fflush(stdout); bg_out_len = 0; }
+static void bg_put(const char* s, size_t n){
+    if(bg_out_len + n > sizeof bg_out){ bg_flush(); if(n > sizeof bg_out){ fwrite(s, 1, n, stdout); return; } }
+    memcpy(bg_out + bg_out_len, s, n); bg_out_len += n;
+}
+static int bg_peek(void){
+    if(bg_in_pos == bg_in_len){
+        if(bg_in_eof) return EOF;
+        bg_in_len = fread(bg_in, 1, sizeof bg_in, stdin); bg_in_pos = 0;
+        if(bg_in_len == 0){ bg_in_eof = 1; return EOF; }
+    }
+    return (unsigned char)bg_in[bg_in_pos];
+}
+static void bg_skip(void){ bg_in_pos++; }
+static int bg_skip_space(void){ int c; while((c = bg_peek()) != EOF && isspace(c)) bg_skip(); return c; }
+
+// 1 = parsed, 0 = malformed, -1 = out of range, 2 = no input left
+static int bg_scan_long(long long* v){
+    int c = bg_skip_space(), neg = 0, digits = 0, over = 0; unsigned long long acc = 0;
+    if(c == EOF) return 2;
+    if(c == '+' || c == '-'){ neg = c == '-'; bg_skip(); }
+    while((c = bg_peek()) != EOF && isdigit(c)){
+        if(acc > (ULLONG_MAX - 9) / 10) over = 1; else acc = acc * 10 + (c - '0');
+        digits++; bg_skip();
+    }
+    if(!digits){ *v = 0; return 0; }
+    if(over || acc > (unsigned long long)LLONG_MAX + neg){ *v = neg ? LLONG_MIN : LLONG_MAX; return -1; }
+    *v = neg ? -(long long)acc : (long long)acc; return 1;
+}
+void bg_read_int(int* p){
+    long long v; int r;
+    if(bg_failed) return;
+    r = bg_scan_long(&v);
+    if(r == 2){ bg_failed = 1; return; }
+    if(r == 0){ *p = 0; bg_failed = 1; return; }
+    if(r < 0 || v > INT_MAX || v < INT_MIN){ *p = (r < 0 ? v < 0 : v < INT_MIN) ? INT_MIN : INT_MAX; bg_failed = 1; return; }
+    *p = (int)v;
+}
+void bg_read_bool(char* p){
+    long long v; int r;
+    if(bg_failed) return;
+    r = bg_scan_long(&v);
+    if(r == 2){ bg_failed = 1; return; }
+    if(r == 0){ *p = 0; bg_failed = 1; return; }
+    if(r < 0 || (v != 0 && v != 1)){ *p = 1; bg_failed = 1; return; }
+    *p = (char)v;
+}
+void bg_read_double(double* p){
+    char buf[512]; size_t n = 0; int c, mant = 0; char* end; double v;
+    if(bg_failed) return;
+    c = bg_skip_space();
+    if(c == EOF){ bg_failed = 1; return; }
+#define BG_TAKE() do{ if(n < sizeof buf - 1) buf[n++] = (char)c; bg_skip(); c = bg_peek(); }while(0)
+    if(c == '+' || c == '-') BG_TAKE();
+    while(c != EOF && isdigit(c)){ mant = 1; BG_TAKE(); }
+    if(c == '.'){ BG_TAKE(); while(c != EOF && isdigit(c)){ mant = 1; BG_TAKE(); } }
+    if(mant && (c == 'e' || c == 'E')){
+        BG_TAKE(); if(c == '+' || c == '-') BG_TAKE();
+        while(c != EOF && isdigit(c)) BG_TAKE();
+    }
+#undef BG_TAKE
+    buf[n] = 0;
+    if(!mant){ *p = 0; bg_failed = 1; return; }
+    v = strtod(buf, &end);
+    if(*end){ *p = 0; bg_failed = 1; return; }
+    if(v == HUGE_VAL || v == -HUGE_VAL){ *p = v > 0 ? DBL_MAX : -DBL_MAX; bg_failed = 1; return; }
+    *p = v;
+}
+void bg_read_char(char* p){
+    int c;
+    if(bg_failed) return;
+    c = bg_skip_space();
+    if(c == EOF){ bg_failed = 1; return; }
+    bg_skip(); *p = (char)c;
+}
+void bg_print_int(int v){ char b[16]; bg_put(b, (size_t)sprintf(b, "%d", v)); }
+void bg_print_double(double v){ char b[64]; bg_put(b, (size_t)sprintf(b, "%g", v)); }
+void bg_print_char(int v){ char c = (char)v; bg_put(&c, 1); }
+void bg_print_str(const char* s){ bg_put(s, strlen(s)); }
+void* bg_alloc_array(long long count, long long size){
+    void* p = calloc(count > 0 ? (size_t)count : 1, (size_t)size);
+    if(!p){ bg_flush(); fputs("bg: out of memory\n", stderr); exit(134); }
+    return p;
+}
+void bg_exit(int code){ bg_flush(); exit(code); }
+
+// lekha values for the C backend. Functions taking a bg_str by value take ownership of its buffer.
+typedef struct { char* p; size_t n, cap; } bg_str;
+static void bg_str_reserve(bg_str* s, size_t n){
+    size_t cap = s->cap ? s->cap : 16;
+    if(n <= s->cap) return;
+    while(cap < n) cap *= 2;
+    s->p = (char*)realloc(s->p, cap);
+    if(!s->p){ bg_flush(); fputs("bg: out of memory\n", stderr); exit(134); }
+    s->cap = cap;
+}
+bg_str bg_str_lit(const char* p, size_t n){ bg_str s = {0, 0, 0}; if(n){ bg_str_reserve(&s, n); memcpy(s.p, p, n); s.n = n; } return s; }
+bg_str bg_str_dup(const bg_str* s){ return bg_str_lit(s->p, s->n); }
+bg_str bg_str_char(int c){ char ch = (char)c; return bg_str_lit(&ch, 1); }
+bg_str bg_str_cat(bg_str a, bg_str b){
+    if(b.n){ bg_str_reserve(&a, a.n + b.n); memcpy(a.p + a.n, b.p, b.n); a.n += b.n; }
+    free(b.p); return a;
+}
+void bg_str_set(bg_str* d, bg_str v){ free(d->p); *d = v; }
+void bg_str_append(bg_str* d, bg_str v){ *d = bg_str_cat(*d, v); }
+// Same ordering as std::string::compare; the _ref forms borrow instead of consuming
+int bg_str_cmp_ref(const bg_str* a, const bg_str* b){
+    size_t n = a->n < b->n ? a->n : b->n; int r = n ? memcmp(a->p, b->p, n) : 0;
+    return r ? r : a->n < b->n ? -1 : a->n > b->n;
+}
+int bg_str_cmp(bg_str a, bg_str b){ int r = bg_str_cmp_ref(&a, &b); free(a.p); free(b.p); return r; }
+void bg_str_free(bg_str* s){ free(s->p); s->p = 0; s->n = s->cap = 0; }
+void bg_print_bgstr_ref(const bg_str* s){ if(s->n) bg_put(s->p, s->n); }
+void bg_print_bgstr(bg_str s){ bg_print_bgstr_ref(&s); free(s.p); }
+// getline(cin >> ws, s)
+void bg_read_line(bg_str* s){
+    int c;
+    if(bg_failed) return;
+    if(bg_skip_space() == EOF){ bg_failed = 1; return; }
+    s->n = 0;
+    while((c = bg_peek()) != EOF && c != '\n'){ bg_str_reserve(s, s->n + 1); s->p[s->n++] = (char)c; bg_skip(); }
+    if(c == '\n') bg_skip();
+}
+)";
+
+// Prototypes for C sources that link against the runtime object
+static const char* BG_NATIVE_RUNTIME_DECLS = R"(#include <stdbool.h>
+#include <stddef.h>
+typedef struct { char* p; size_t n, cap; } bg_str;
+void bg_read_int(int*); void bg_read_double(double*); void bg_read_char(char*); void bg_read_bool(char*);
+void bg_print_int(int); void bg_print_double(double); void bg_print_char(int); void bg_print_str(const char*);
+void* bg_alloc_array(long long, long long); void bg_exit(int);
+bg_str bg_str_lit(const char*, size_t); bg_str bg_str_dup(const bg_str*); bg_str bg_str_char(int);
+bg_str bg_str_cat(bg_str, bg_str); void bg_str_set(bg_str*, bg_str); void bg_str_append(bg_str*, bg_str);
+int bg_str_cmp(bg_str, bg_str); int bg_str_cmp_ref(const bg_str*, const bg_str*); void bg_str_free(bg_str*);
+void bg_print_bgstr(bg_str); void bg_print_bgstr_ref(const bg_str*); void bg_read_line(bg_str*);
+)";
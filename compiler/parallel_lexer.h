@@ -0,0 +1,69 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <vector>
+#include "compilation_unit.h"
+#include "lexer.h"
+#include "thread_pool.h"
+
+// Sources smaller than this are lexed serially; chunking would cost more than it saves
+static const size_t BG_PARALLEL_LEX_MIN_CHUNK = 256 * 1024;
+
+// Splits the source at line starts into roughly equal chunks. A token only continues past a '\n'
+// when a string escape swallows it, so lines that follow a backslash are never used as cut points.
+inline std::vector<size_t> lexChunkLines(const CompilationUnit& unit, size_t chunks) {
+    std::vector<size_t> firstLines{0};
+    const std::string& src = unit.source;
+    size_t target = src.size() / chunks;
+    for (size_t k = 1; k < chunks; ++k) {
+        size_t want = k * target;
+        size_t li = std::lower_bound(unit.lineStarts.begin(), unit.lineStarts.end(), want) - unit.lineStarts.begin();
+        while (li < unit.lineCount() && unit.lineStarts[li] >= 2 && src[unit.lineStarts[li] - 2] == '\\') li++;
+        if (li >= unit.lineCount()) break;
+        if (li > firstLines.back()) firstLines.push_back(li);
+    }
+    return firstLines;
+}
+
+// Lexes independent chunks on the pool and stitches the token arrays back together. The result,
+// line/col included, is identical to a serial Lexer run over the whole source.
+inline std::vector<Token> lexParallel(const CompilationUnit& unit, ThreadPool& pool) {
+    const std::string& src = unit.source;
+    size_t chunks = std::min(pool.size() * 4, src.size() / BG_PARALLEL_LEX_MIN_CHUNK);
+    // The serial lexer stops at an embedded NUL, which a chunked run cannot reproduce
+    if (chunks < 2 || std::memchr(src.data(), '\0', src.size()) != nullptr) {
+        Lexer lexer(src);
+        lexer.lex();
+        return std::move(lexer.tokens);
+    }
+    std::vector<size_t> firstLines = lexChunkLines(unit, chunks);
+    std::vector<std::future<Lexer>> parts;
+    for (size_t k = 0; k < firstLines.size(); ++k) {
+        size_t begin = unit.lineStarts[firstLines[k]];
+        size_t end = k + 1 < firstLines.size() ? unit.lineStarts[firstLines[k + 1]] : src.size();
+        int firstLine = (int)firstLines[k] + 1;
+        bool last = k + 1 == firstLines.size();
+        parts.push_back(pool.submit([&src, begin, end, firstLine, last] {
+            Lexer lexer(std::string_view(src).substr(begin, end - begin));
+            lexer.line = firstLine;
+            while (lexer.next()) {}
+            if (last) lexer.finish();
+            return lexer;
+        }));
+    }
+    std::vector<Lexer> lexers;
+    for (auto& part : parts) lexers.push_back(part.get());
+    size_t total = 0;
+    std::vector<size_t> offsets;
+    for (auto& lexer : lexers) { offsets.push_back(total); total += lexer.tokens.size(); }
+    std::vector<Token> tokens(total);
+    std::vector<std::future<void>> moves;
+    for (size_t k = 0; k < lexers.size(); ++k) {
+        moves.push_back(pool.submit([&, k] {
+            std::move(lexers[k].tokens.begin(), lexers[k].tokens.end(), tokens.begin() + offsets[k]);
+        }));
+    }
+    for (auto& move : moves) move.get();
+    return tokens;
+}
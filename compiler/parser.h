@@ -1,6 +1,10 @@
 #pragma once
+#include <map>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 #include <fstream>
 #include <sstream>
@@ -10,100 +14,175 @@
 struct ParseError {
     int line;
     int col;
-    std::string type;
+    std::string_view type;      // Types and contexts are string constants shared by every diagnostic
     std::string message;
-    std::string context;
-    ParseError(int l, int c, const std::string& t, const std::string& m, const std::string& ctx = "")
-        : line(l), col(c), type(t), message(m), context(ctx) {}
+    std::string_view context;
+    size_t repeats = 0;         // Later diagnostics of this type about the same symbol, folded into this one
+    ParseError(int l, int c, std::string_view t, std::string m, std::string_view ctx = {})
+        : line(l), col(c), type(t), message(std::move(m)), context(ctx) {}
 };
+// Diagnostics of one run. One about a symbol is kept once per type and symbol, later ones only count as
+// repeats of it, and each severity keeps its first DETAIL_LIMIT entries; the rest are counted per type.
+// Memory and error_log.txt stay bounded however many diagnostics an input produces.
 class ErrorLogger {
+public:
+    static const size_t DETAIL_LIMIT = 1000;
+    // Process-lifetime copy of a type or context that is not a string literal (one read back from a cache)
+    static std::string_view shared(std::string_view text) {
+        static std::mutex lock;
+        static std::unordered_set<std::string> pool;
+        std::lock_guard<std::mutex> guard(lock);
+        return *pool.emplace(text).first;
+    }
 private:
-    std::vector<ParseError> errors;
-    std::vector<ParseError> warnings;
+    struct Severity {
+        std::vector<ParseError> kept;
+        std::map<std::string_view, std::unordered_map<std::string, size_t>> bySymbol;  // type -> symbol -> index in kept
+        std::map<std::string_view, size_t> suppressed;  // type -> entries past DETAIL_LIMIT
+        size_t total = 0;
+        bool full() const { return kept.size() >= DETAIL_LIMIT; }
+        void add(int line, int col, std::string_view type, std::string message, std::string_view context) {
+            ++total;
+            if (full()) ++suppressed[type];
+            else kept.emplace_back(line, col, type, std::move(message), context);
+        }
+        // "<what>: '<symbol>'", built only for the first of its type and symbol
+        void addSymbol(int line, int col, std::string_view type, std::string_view what, const std::string& symbol, std::string_view context) {
+            auto& symbols = bySymbol[type];
+            auto it = symbols.find(symbol);
+            if (it != symbols.end()) {
+                ++total;
+                ++kept[it->second].repeats;
+                return;
+            }
+            if (!full()) symbols.emplace(symbol, kept.size());
+            add(line, col, type, full() ? std::string() : std::string(what) + ": '" + symbol + "'", context);
+        }
+        // Entries of another logger as if added after these; their symbols are not merged
+        void append(const Severity& other) {
+            for (const ParseError& e : other.kept) {
+                total += 1 + e.repeats;
+                if (full()) suppressed[e.type] += 1 + e.repeats;
+                else kept.push_back(e);
+            }
+            for (const auto& entry : other.suppressed) {
+                total += entry.second;
+                suppressed[entry.first] += entry.second;
+            }
+        }
+        void write(std::ostream& log, const char* title, const char* rule, const char* label, const char* plural) const {
+            log << title << " (" << total << "):\n" << rule << "\n";
+            for (const auto& e : kept) {
+                log << label << " [Line " << e.line << ", Col " << e.col << "] " << e.type << ": " << e.message;
+                if (!e.context.empty()) {
+                    log << "\n  Context: " << e.context;
+                }
+                if (e.repeats) {
+                    log << "\n  Repeated: " << e.repeats << " more time(s), not listed";
+                }
+                log << "\n\n";
+            }
+            for (const auto& entry : suppressed) {
+                log << "SUPPRESSED: " << entry.second << " more " << entry.first << " " << plural
+                    << " after the first " << DETAIL_LIMIT << "\n\n";
+            }
+        }
+    };
+    Severity errors;
+    Severity warnings;
     std::string logFile;
 public:
     ErrorLogger(const std::string& filename = "error_log.txt") : logFile(filename) {}
-    void addError(int line, int col, const std::string& type, const std::string& message, const std::string& context = "") {
-        errors.push_back(ParseError(line, col, type, message, context));
+    void addError(int line, int col, std::string_view type, std::string message, std::string_view context = {}) {
+        errors.add(line, col, type, std::move(message), context);
+    }
+    void addWarning(int line, int col, std::string_view type, std::string message, std::string_view context = {}) {
+        warnings.add(line, col, type, std::move(message), context);
+    }
+    // Diagnostics about one symbol, reported as "<what>: '<symbol>'" once per type and symbol
+    void addSymbolError(int line, int col, std::string_view type, std::string_view what, const std::string& symbol, std::string_view context) {
+        errors.addSymbol(line, col, type, what, symbol, context);
     }
-    void addWarning(int line, int col, const std::string& type, const std::string& message, const std::string& context = "") {
-        warnings.push_back(ParseError(line, col, type, message, context));
+    void addSymbolWarning(int line, int col, std::string_view type, std::string_view what, const std::string& symbol, std::string_view context) {
+        warnings.addSymbol(line, col, type, what, symbol, context);
+    }
+    // Puts back what a logger kept, for re-rendering its log (see AnalysisCache); symbols are not restored
+    void restore(bool error, ParseError entry) {
+        Severity& s = error ? errors : warnings;
+        s.total += 1 + entry.repeats;
+        s.kept.push_back(std::move(entry));
+    }
+    void restoreSuppressed(bool error, std::string_view type, size_t count) {
+        Severity& s = error ? errors : warnings;
+        s.total += count;
+        s.suppressed[type] += count;
     }
     void writeLog() {
         std::ofstream log(logFile);
+        writeLog(log);
+    }
+    // Same report as error_log.txt, written to any stream
+    void writeLog(std::ostream& log) const {
         log << "=== BANGLISH COMPILER ERROR LOG ===\n\n";
-        if (errors.empty() && warnings.empty()) {
+        if (!errors.total && !warnings.total) {
             log << "No errors or improvements found.\n";
             return;
         }
-        if (!errors.empty()) {
-            log << "ERRORS (" << errors.size() << "):\n";
-            log << "==================\n";
-            for (const auto& error : errors) {
-                log << "ERROR [Line " << error.line << ", Col " << error.col << "] "
-                    << error.type << ": " << error.message;
-                if (!error.context.empty()) {
-                    log << "\n  Context: " << error.context;
-                }
-                log << "\n\n";
-            }
-        }
-        if (!warnings.empty()) {
-            log << "IMPROVEMENTS (" << warnings.size() << "):\n";
-            log << "====================\n";
-            for (const auto& warning : warnings) {
-                log << "IMPROVEMENT [Line " << warning.line << ", Col " << warning.col << "] "
-                    << warning.type << ": " << warning.message;
-                if (!warning.context.empty()) {
-                    log << "\n  Context: " << warning.context;
-                }
-                log << "\n\n";
-            }
-        }
+        if (errors.total) errors.write(log, "ERRORS", "==================", "ERROR", "error(s)");
+        if (warnings.total) warnings.write(log, "IMPROVEMENTS", "====================", "IMPROVEMENT", "improvement(s)");
         log << "=== END OF LOG ===\n";
-        log.close();
     }
-    bool hasErrors() const { return !errors.empty(); }
-    bool hasWarnings() const { return !warnings.empty(); }
-    size_t getErrorCount() const { return errors.size(); }
-    size_t getWarningCount() const { return warnings.size(); }
+    // Appends another logger's entries after this one's, keeping each list in order
+    void append(const ErrorLogger& other) {
+        errors.append(other.errors);
+        warnings.append(other.warnings);
+    }
+    // Entries as listed in the log; the counts below include repeats and suppressed entries
+    const std::vector<ParseError>& getErrors() const { return errors.kept; }
+    const std::vector<ParseError>& getWarnings() const { return warnings.kept; }
+    const std::map<std::string_view, size_t>& getSuppressedErrors() const { return errors.suppressed; }
+    const std::map<std::string_view, size_t>& getSuppressedWarnings() const { return warnings.suppressed; }
+    bool hasErrors() const { return errors.total != 0; }
+    bool hasWarnings() const { return warnings.total != 0; }
+    size_t getErrorCount() const { return errors.total; }
+    size_t getWarningCount() const { return warnings.total; }
 };
 class BanglishParser {
 private:
-    std::vector<Token> tokens;
+    const std::vector<Token>& tokens;
     size_t currentIndex;
+    const Token eofToken{"EOF", "", 0, 0};
     ErrorLogger& logger;
-    std::unordered_set<std::string> validKeywords = {
+    // Tables and patterns are built once per process and shared read-only by every parser
+    static inline const std::unordered_set<std::string> validKeywords = {
         "shuru", "shesh", "purno sonkha", "dosomik sonkha", "lekha", 
         "akkhor", "sotto-mittha", "jodi", "nahoy jodi", "nahoy", 
         "poro", "dekhao", "loop", "ferot dao"
     };
-    std::unordered_set<std::string> validOperators = {
+    static inline const std::unordered_set<std::string> validOperators = {
         "+", "-", "*", "/", "%", "++", "--", "+=", "-=", "*=", "/=", "%=",
         "==", "!=", "<=", ">=", "<", ">", "!", "&&", "||", "&", "|",
         "=", "(", ")", "{", "}", "[", "]", ";", ",", "'"
     };
-    std::regex identifierPattern{R"(^[A-Za-z_][A-Za-z0-9_]*$)"};
-    std::regex numberPattern{R"(^[0-9]+(?:\.[0-9]+)?$)"};
-    std::regex stringPattern{R"(^"(?:[^"\\]|\\.)*"$)"};
-    std::regex charPattern{R"(^'(?:[^'\\]|\\.)+'$)"};
-    std::regex banglishNamingPattern{R"(^[A-Za-z_][A-Za-z0-9_]*$)"};
-    std::regex invalidStartPattern{R"(^[0-9].*$)"};
-    std::regex invalidCharPattern{R"(.*[\s\-].*)"};
+    static inline const std::regex identifierPattern{R"(^[A-Za-z_][A-Za-z0-9_]*$)"};
+    static inline const std::regex numberPattern{R"(^[0-9]+(?:\.[0-9]+)?$)"};
+    static inline const std::regex stringPattern{R"(^"(?:[^"\\]|\\.)*"$)"};
+    static inline const std::regex charPattern{R"(^'(?:[^'\\]|\\.)+'$)"};
+    static inline const std::regex banglishNamingPattern{R"(^[A-Za-z_][A-Za-z0-9_]*$)"};
+    static inline const std::regex invalidStartPattern{R"(^[0-9].*$)"};
+    static inline const std::regex invalidCharPattern{R"(.*[\s\-].*)"};
 public:
     BanglishParser(const std::vector<Token>& toks, ErrorLogger& log) 
         : tokens(toks), currentIndex(0), logger(log) {}
-    Token& current() {
+    const Token& current() const {
         if (currentIndex >= tokens.size()) {
-            static Token eofToken{"EOF", "", 0, 0};
             return eofToken;
         }
         return tokens[currentIndex];
     }
-    Token& peek(int offset = 1) {
+    const Token& peek(int offset = 1) const {
         size_t index = currentIndex + offset;
         if (index >= tokens.size()) {
-            static Token eofToken{"EOF", "", 0, 0};
             return eofToken;
         }
         return tokens[index];
@@ -116,35 +195,37 @@ public:
     void validateKeyword(const Token& token) {
         if (token.type == "KEYWORD") {
             if (validKeywords.find(token.lexeme) == validKeywords.end()) {
-                logger.addError(token.line, token.col, "INVALID_KEYWORD", 
-                    "Unknown keyword: '" + token.lexeme + "'", 
+                logger.addSymbolError(token.line, token.col, "INVALID_KEYWORD",
+                    "Unknown keyword", token.lexeme, 
                     "Expected one of: shuru, shesh, purno sonkha, dosomik sonkha, etc.");
             }
         }
     }
     void validateIdentifier(const Token& token) {
         if (token.type == "IDENT") {
-            if (!std::regex_match(token.lexeme, identifierPattern)) {
-                logger.addError(token.line, token.col, "INVALID_IDENTIFIER", 
-                    "Invalid identifier: '" + token.lexeme + "'",
+            // Lexer-shaped identifiers pass all three pattern checks below without touching std::regex
+            bool plain = isIdentifierShape(token.lexeme);
+            if (!plain && !std::regex_match(token.lexeme, identifierPattern)) {
+                logger.addSymbolError(token.line, token.col, "INVALID_IDENTIFIER",
+                    "Invalid identifier", token.lexeme,
                     "Identifiers must start with letter or underscore, followed by letters, digits, or underscores");
                 return;
             }
-            if (std::regex_match(token.lexeme, invalidStartPattern)) {
-                logger.addError(token.line, token.col, "INVALID_IDENTIFIER", 
-                    "Identifier cannot start with digit: '" + token.lexeme + "'",
+            if (!plain && std::regex_match(token.lexeme, invalidStartPattern)) {
+                logger.addSymbolError(token.line, token.col, "INVALID_IDENTIFIER",
+                    "Identifier cannot start with digit", token.lexeme,
                     "Use letters or underscore to start identifier names");
                 return;
             }
-            if (std::regex_match(token.lexeme, invalidCharPattern)) {
-                logger.addError(token.line, token.col, "INVALID_IDENTIFIER", 
-                    "Identifier contains invalid characters: '" + token.lexeme + "'",
+            if (!plain && std::regex_match(token.lexeme, invalidCharPattern)) {
+                logger.addSymbolError(token.line, token.col, "INVALID_IDENTIFIER",
+                    "Identifier contains invalid characters", token.lexeme,
                     "Use underscore (_) instead of spaces or hyphens");
                 return;
             }
             if (validKeywords.find(token.lexeme) != validKeywords.end()) {
-                logger.addError(token.line, token.col, "RESERVED_KEYWORD", 
-                    "Cannot use reserved keyword as identifier: '" + token.lexeme + "'",
+                logger.addSymbolError(token.line, token.col, "RESERVED_KEYWORD",
+                    "Cannot use reserved keyword as identifier", token.lexeme,
                     "Choose a different name for your variable");
                 return;
             }
@@ -152,141 +233,165 @@ public:
         }
     }
     void validateNamingConvention(const Token& token) {
-        if (token.lexeme.length() == 1) {
-            logger.addWarning(token.line, token.col, "NAMING_CONVENTION", 
-                "Single character variable name: '" + token.lexeme + "'",
+        if (bg::utf8::length(token.lexeme) == 1) {
+            logger.addSymbolWarning(token.line, token.col, "NAMING_CONVENTION",
+                "Single character variable name", token.lexeme,
                 "Consider using more descriptive names");
         }
         if (token.lexeme == "temp" || token.lexeme == "tmp" || token.lexeme == "var") {
-            logger.addWarning(token.line, token.col, "NAMING_CONVENTION", 
-                "Generic variable name: '" + token.lexeme + "'",
+            logger.addSymbolWarning(token.line, token.col, "NAMING_CONVENTION",
+                "Generic variable name", token.lexeme,
                 "Use more specific and meaningful names");
         }
+        // Bengali has no case, so names using it are never all-caps
         bool allCaps = true;
         for (char c : token.lexeme) {
-            if (islower(c)) {
+            if (islower(c) || (unsigned char)c >= 0x80) {
                 allCaps = false;
                 break;
             }
         }
-        if (allCaps && token.lexeme.length() > 1) {
-            logger.addWarning(token.line, token.col, "NAMING_CONVENTION", 
-                "All-caps variable name: '" + token.lexeme + "'",
+        if (allCaps && bg::utf8::length(token.lexeme) > 1) {
+            logger.addSymbolWarning(token.line, token.col, "NAMING_CONVENTION",
+                "All-caps variable name", token.lexeme,
                 "Reserve all-caps for constants, use camelCase or snake_case for variables");
         }
     }
     void validateOperator(const Token& token) {
         if (token.type == "OP") {
             if (validOperators.find(token.lexeme) == validOperators.end()) {
-                logger.addError(token.line, token.col, "INVALID_OPERATOR", 
-                    "Unknown operator: '" + token.lexeme + "'",
+                logger.addSymbolError(token.line, token.col, "INVALID_OPERATOR",
+                    "Unknown operator", token.lexeme,
                     "Check for typos in operator usage");
             }
         }
     }
     void validateLiteral(const Token& token) {
         if (token.type == "NUMBER") {
-            if (!std::regex_match(token.lexeme, numberPattern)) {
-                logger.addError(token.line, token.col, "INVALID_NUMBER", 
-                    "Invalid number format: '" + token.lexeme + "'",
+            if (!isNumberShape(token.lexeme) && !std::regex_match(token.lexeme, numberPattern)) {
+                logger.addSymbolError(token.line, token.col, "INVALID_NUMBER",
+                    "Invalid number format", token.lexeme,
                     "Numbers should be integers or decimals (e.g., 123, 45.67)");
             }
         } else if (token.type == "STRING") {
-            if (!std::regex_match(token.lexeme, stringPattern)) {
-                logger.addError(token.line, token.col, "INVALID_STRING", 
-                    "Invalid string format: '" + token.lexeme + "'",
+            if (!isStringShape(token.lexeme) && !std::regex_match(token.lexeme, stringPattern)) {
+                logger.addSymbolError(token.line, token.col, "INVALID_STRING",
+                    "Invalid string format", token.lexeme,
                     "Strings should be enclosed in double quotes");
             }
         }
     }
-    void validateStructure() {
+    // Incremental form of validateStructure so a single token sweep can drive it
+    struct StructureState {
         bool hasShuru = false;
         bool hasShesh = false;
         int braceDepth = 0;
         int parenDepth = 0;
         int bracketDepth = 0;
-        for (const auto& token : tokens) {
-            if (token.type == "KEYWORD") {
-                if (token.lexeme == "shuru") {
-                    if (hasShuru) {
-                        logger.addError(token.line, token.col, "DUPLICATE_SHURU", 
-                            "Multiple 'shuru' statements found",
-                            "Program should have only one 'shuru' at the beginning");
-                    }
-                    hasShuru = true;
-                } else if (token.lexeme == "shesh") {
-                    if (hasShesh) {
-                        logger.addError(token.line, token.col, "DUPLICATE_SHESH", 
-                            "Multiple 'shesh' statements found",
-                            "Program should have only one 'shesh' at the end");
-                    }
-                    hasShesh = true;
-                }
-            } else if (token.type == "OP") {
-                if (token.lexeme == "{") braceDepth++;
-                else if (token.lexeme == "}") braceDepth--;
-                else if (token.lexeme == "(") parenDepth++;
-                else if (token.lexeme == ")") parenDepth--;
-                else if (token.lexeme == "[") bracketDepth++;
-                else if (token.lexeme == "]") bracketDepth--;
-                if (braceDepth < 0) {
-                    logger.addError(token.line, token.col, "UNMATCHED_BRACE", 
-                        "Closing brace '}' without matching opening brace '{'",
-                        "Check brace pairing in your code");
-                }
-                if (parenDepth < 0) {
-                    logger.addError(token.line, token.col, "UNMATCHED_PAREN", 
-                        "Closing parenthesis ')' without matching opening parenthesis '('",
-                        "Check parenthesis pairing in your code");
+    };
+    void checkStructure(const Token& token, StructureState& st, ErrorLogger& out) {
+        if (token.type == "KEYWORD") {
+            if (token.lexeme == "shuru") {
+                if (st.hasShuru) {
+                    out.addError(token.line, token.col, "DUPLICATE_SHURU", 
+                        "Multiple 'shuru' statements found",
+                        "Program should have only one 'shuru' at the beginning");
                 }
-                if (bracketDepth < 0) {
-                    logger.addError(token.line, token.col, "UNMATCHED_BRACKET", 
-                        "Closing bracket ']' without matching opening bracket '['",
-                        "Check bracket pairing in your code");
+                st.hasShuru = true;
+            } else if (token.lexeme == "shesh") {
+                if (st.hasShesh) {
+                    out.addError(token.line, token.col, "DUPLICATE_SHESH", 
+                        "Multiple 'shesh' statements found",
+                        "Program should have only one 'shesh' at the end");
                 }
+                st.hasShesh = true;
+            }
+        } else if (token.type == "OP") {
+            if (token.lexeme == "{") st.braceDepth++;
+            else if (token.lexeme == "}") st.braceDepth--;
+            else if (token.lexeme == "(") st.parenDepth++;
+            else if (token.lexeme == ")") st.parenDepth--;
+            else if (token.lexeme == "[") st.bracketDepth++;
+            else if (token.lexeme == "]") st.bracketDepth--;
+            // A stray closer is reported at itself and the depth restarts at zero, so the tokens after it
+            // are not each reported again and later pairs are checked normally
+            if (st.braceDepth < 0) {
+                out.addError(token.line, token.col, "UNMATCHED_BRACE", 
+                    "Closing brace '}' without matching opening brace '{'",
+                    "Check brace pairing in your code");
+                st.braceDepth = 0;
+            }
+            if (st.parenDepth < 0) {
+                out.addError(token.line, token.col, "UNMATCHED_PAREN", 
+                    "Closing parenthesis ')' without matching opening parenthesis '('",
+                    "Check parenthesis pairing in your code");
+                st.parenDepth = 0;
+            }
+            if (st.bracketDepth < 0) {
+                out.addError(token.line, token.col, "UNMATCHED_BRACKET", 
+                    "Closing bracket ']' without matching opening bracket '['",
+                    "Check bracket pairing in your code");
+                st.bracketDepth = 0;
             }
         }
-        if (!hasShuru) {
-            logger.addError(1, 1, "MISSING_SHURU", 
+    }
+    void finishStructure(const StructureState& st, ErrorLogger& out) {
+        if (!st.hasShuru) {
+            out.addError(1, 1, "MISSING_SHURU", 
                 "Program must start with 'shuru'",
                 "Add 'shuru' at the beginning of your program");
         }
-        if (!hasShesh) {
+        if (!st.hasShesh) {
             int lastLine = tokens.empty() ? 1 : tokens.back().line;
-            logger.addError(lastLine, 1, "MISSING_SHESH", 
+            out.addError(lastLine, 1, "MISSING_SHESH", 
                 "Program must end with 'shesh'",
                 "Add 'shesh' at the end of your program");
         }
-        if (braceDepth > 0) {
-            logger.addError(tokens.back().line, tokens.back().col, "UNCLOSED_BRACE", 
-                std::to_string(braceDepth) + " unclosed brace(s) '{'",
+        if (st.braceDepth > 0) {
+            out.addError(tokens.back().line, tokens.back().col, "UNCLOSED_BRACE", 
+                std::to_string(st.braceDepth) + " unclosed brace(s) '{'",
                 "Add missing closing brace(s) '}'");
         }
-        if (parenDepth > 0) {
-            logger.addError(tokens.back().line, tokens.back().col, "UNCLOSED_PAREN", 
-                std::to_string(parenDepth) + " unclosed parenthesis(es) '('",
+        if (st.parenDepth > 0) {
+            out.addError(tokens.back().line, tokens.back().col, "UNCLOSED_PAREN", 
+                std::to_string(st.parenDepth) + " unclosed parenthesis(es) '('",
                 "Add missing closing parenthesis(es) ')'");
         }
-        if (bracketDepth > 0) {
-            logger.addError(tokens.back().line, tokens.back().col, "UNCLOSED_BRACKET", 
-                std::to_string(bracketDepth) + " unclosed bracket(s) '['",
+        if (st.bracketDepth > 0) {
+            out.addError(tokens.back().line, tokens.back().col, "UNCLOSED_BRACKET", 
+                std::to_string(st.bracketDepth) + " unclosed bracket(s) '['",
                 "Add missing closing bracket(s) ']'");
         }
     }
-    void parse() {
+    void validateStructure() {
+        StructureState st;
         for (const auto& token : tokens) {
-            if (token.type == "ERROR") {
-                if (token.lexeme == "UNCLOSED_STRING") {
-                    logger.addError(token.line, token.col, "UNCLOSED_STRING", 
-                        "String literal is not properly closed",
-                        "Add closing quote (\") to end the string");
-                }
-                continue;
+            checkStructure(token, st, logger);
+        }
+        finishStructure(st, logger);
+    }
+    // Per-token checks run by parse(); the fused front end calls this as each token is lexed
+    void checkToken(const Token& token) {
+        if (token.type == "ERROR") {
+            if (token.lexeme == "UNCLOSED_STRING") {
+                logger.addError(token.line, token.col, "UNCLOSED_STRING", 
+                    "String literal is not properly closed",
+                    "Add closing quote (\") to end the string");
+            } else if (token.lexeme == "INVALID_UTF8") {
+                logger.addError(token.line, token.col, "INVALID_UTF8",
+                    "Malformed UTF-8 byte sequence",
+                    "Save main.banglish as UTF-8");
             }
-            validateKeyword(token);
-            validateIdentifier(token);
-            validateOperator(token);
-            validateLiteral(token);
+            return;
+        }
+        validateKeyword(token);
+        validateIdentifier(token);
+        validateOperator(token);
+        validateLiteral(token);
+    }
+    void parse() {
+        for (const auto& token : tokens) {
+            checkToken(token);
         }
         validateStructure();
         validateStatementSyntax();
@@ -302,7 +407,7 @@ public:
         }
     }
     void validateStatement() {
-        Token& token = current();
+        const Token& token = current();
         if (token.lexeme == "purno sonkha" || token.lexeme == "dosomik sonkha" || 
             token.lexeme == "lekha" || token.lexeme == "akkhor" || token.lexeme == "sotto-mittha") {
             validateDeclaration();
@@ -320,13 +425,21 @@ public:
             advance();
         }
     }
+    // Contexts are shared constants, so the one naming the declared type comes from a fixed set
+    static std::string_view declarationSyntax(const std::string& type) {
+        if (type == "purno sonkha") return "Declaration syntax: purno sonkha variable_name;";
+        if (type == "dosomik sonkha") return "Declaration syntax: dosomik sonkha variable_name;";
+        if (type == "lekha") return "Declaration syntax: lekha variable_name;";
+        if (type == "akkhor") return "Declaration syntax: akkhor variable_name;";
+        return "Declaration syntax: sotto-mittha variable_name;";
+    }
     void validateDeclaration() {
-        Token& typeToken = current();
+        const Token& typeToken = current();
         advance();
         if (current().type != "IDENT") {
             logger.addError(current().line, current().col, "SYNTAX_ERROR", 
                 "Expected identifier after type declaration",
-                "Declaration syntax: " + typeToken.lexeme + " variable_name;");
+                declarationSyntax(typeToken.lexeme));
             return;
         }
         advance();
@@ -446,7 +559,7 @@ public:
         }
     }
     void validateReturnStatement() {
-        Token& token = current();
+        const Token& token = current();
         if (token.lexeme == "ferot dao") {
             advance();
         } else {
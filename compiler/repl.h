@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "compilation_unit.h"
+#include "interpreter.h"
+#include "lexer.h"
+#include "parser.h"
+#include "symbol_table.h"
+
+// State behind --repl. Each input is lexed, checked by the parser's diagnostics, lowered and run at once in
+// the interpreter, against the variables earlier inputs declared. The Program only ever grows by
+// declarations (their cells hold the values); statements are dropped once they have run.
+class ReplSession {
+public:
+    struct Timing {
+        std::string source;     // First line of the input
+        double lexUs = 0, checkUs = 0, parseUs = 0, runUs = 0;
+        double totalUs() const { return lexUs + checkUs + parseUs + runUs; }
+    };
+    struct Result {
+        std::string output;                 // What dekhao printed, and the value of a bare expression
+        std::vector<std::string> errors;    // Diagnostics that stopped the input, or the runtime fault
+        bool exited = false;                // Ran `ferot dao`; the session itself carries on
+        int exitCode = 0;
+        Timing timing;
+    };
+    static const size_t HISTORY = 1000;     // Inputs whose timings are kept
+
+    explicit ReplSession(std::istream& input) : interpreter(program, input, out), scopes(1) {}
+
+    // Whether `text` can run yet: brackets must be closed, and a jodi waits for a blank line in case a nahoy follows
+    static bool complete(const std::string& text, bool blankLine){
+        Lexer lexer(text);
+        lexer.lex();
+        int depth = 0;
+        for(const Token& t: lexer.tokens){
+            if(t.type!="OP") continue;
+            if(t.lexeme=="{" || t.lexeme=="(" || t.lexeme=="[") depth++;
+            else if(t.lexeme=="}" || t.lexeme==")" || t.lexeme=="]") depth--;
+        }
+        if(depth > 0) return false;
+        bool jodi = !lexer.tokens.empty() && lexer.tokens[0].type=="KEYWORD" && lexer.tokens[0].lexeme=="jodi";
+        return !jodi || blankLine;
+    }
+
+    Result evaluate(const std::string& text){
+        using clock = std::chrono::steady_clock;
+        auto us = [](clock::time_point a, clock::time_point b){ return std::chrono::duration<double, std::micro>(b - a).count(); };
+        Result r;
+        r.timing.source = text.substr(0, text.find('\n'));
+        ++inputs;
+
+        auto start = clock::now();
+        CompilationUnit unit(text);
+        Lexer lexer(unit.source);
+        lexer.lex();
+        // shuru and shesh may be typed but mean nothing here
+        lexer.tokens.erase(std::remove_if(lexer.tokens.begin(), lexer.tokens.end(), [](const Token& t){
+            return t.type=="KEYWORD" && (t.lexeme=="shuru" || t.lexeme=="shesh");
+        }), lexer.tokens.end());
+        unit.tokens = std::move(lexer.tokens);
+        auto lexed = clock::now();
+        r.timing.lexUs = us(start, lexed);
+
+        // The per-token and statement checks of the driver; structure checks would only see a fragment
+        ErrorLogger log("");
+        BanglishParser checker(unit.tokens, log);
+        for(const Token& t: unit.tokens) checker.checkToken(t);
+        checker.validateStatementSyntax();
+        r.timing.checkUs = us(lexed, clock::now());
+        if(log.hasErrors()){
+            for(const ParseError& e: log.getErrors()){
+                r.errors.push_back("ERROR [Line " + std::to_string(e.line) + ", Col " + std::to_string(e.col) + "] " +
+                                   std::string(e.type) + ": " + e.message);
+            }
+            record(r.timing);
+            return r;
+        }
+
+        AstParser parser(unit, program, scopes);
+        parser.optionalSemicolon = true;
+        while(!parser.atEnd() && !r.exited){
+            auto parseStart = clock::now();
+            StmtPtr s;
+            try {
+                s = parser.nextStatement();
+                typeStmt(*s);
+            } catch(const LoweringError& e){
+                r.errors.push_back(std::string("error: ") + e.what());
+                break;
+            }
+            scopes = parser.visible();
+            remember(*s);
+            // A bare expression shows its value
+            if(s->kind==Stmt::Eval && s->value->kind!=Expr::Assign && s->value->kind!=Expr::Step){
+                StmtPtr print(new Stmt());
+                print->kind = Stmt::Print;
+                print->line = s->line;
+                print->parts.push_back({false, "", std::move(s->value)});
+                s = std::move(print);
+            }
+            auto runStart = clock::now();
+            r.timing.parseUs += us(parseStart, runStart);
+            try {
+                r.exited = interpreter.execute(*s, r.exitCode);
+            } catch(const InterpreterError& e){
+                r.errors.push_back(std::string("runtime error: ") + e.what());
+                r.output += out.str();
+                out.str("");
+                r.timing.runUs += us(runStart, clock::now());
+                break;
+            }
+            r.output += out.str();
+            out.str("");
+            r.timing.runUs += us(runStart, clock::now());
+        }
+        record(r.timing);
+        return r;
+    }
+
+    // Top-level variables in declaration order, with their current values
+    std::vector<Symbol> symbols() const {
+        std::vector<Symbol> list = table.all();
+        for(Symbol& sym: list){
+            for(const VarInfo* var: declared){
+                if(var->name!=sym.name) continue;
+                sym.value = interpreter.describe(*var);
+                if(var->isArray) sym.arraySize = std::to_string(interpreter.length(*var));
+            }
+        }
+        return list;
+    }
+    const std::deque<Timing>& history() const { return timings; }
+
+private:
+    Program program;
+    std::ostringstream out;
+    Interpreter interpreter;
+    AstParser::Scopes scopes;
+    SymbolTable table;
+    std::vector<const VarInfo*> declared;
+    std::deque<Timing> timings;
+    int inputs = 0;
+
+    void record(const Timing& timing){
+        timings.push_back(timing);
+        if(timings.size() > HISTORY) timings.pop_front();
+    }
+    // Adds what a top-level statement declared to the symbol table; the line is the input's number
+    void remember(const Stmt& s){
+        if(s.kind==Stmt::Block && !s.scoped){ for(const auto& b: s.body) remember(*b); return; }
+        if(s.kind!=Stmt::Declare) return;
+        if(s.var->isArray) table.declareArray(s.var->name, valueTypeName(s.var->type), inputs, "");
+        else table.declare(s.var->name, valueTypeName(s.var->type), inputs);
+        if(s.init || !s.initList.empty()) table.initialize(s.var->name);
+        declared.push_back(s.var);
+    }
+};
@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <map>
+#include <string>
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Wire format shared by banglishd and banglish_client. A message is a set of named fields, each sent as
+// "<name> <byte count>\n<bytes>\n" and closed by "end\n"; a connection carries any number of
+// request/response pairs in turn.
+using Message = std::map<std::string, std::string>;
+
+// Limits a reader enforces before trusting a peer's byte counts; a message over them is treated as malformed
+static const size_t MAX_FIELD_BYTES = 64u << 20;
+static const size_t MAX_MESSAGE_BYTES = 128u << 20;
+static const size_t MAX_HEADER_BYTES = 4096;
+
+// $XDG_RUNTIME_DIR/banglishd.sock, or a per-user path under /tmp
+inline std::string defaultSocketPath(){
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    if(runtime && *runtime) return std::string(runtime) + "/banglishd.sock";
+#ifndef _WIN32
+    return "/tmp/banglishd-" + std::to_string(getuid()) + ".sock";
+#else
+    return "banglishd.sock";
+#endif
+}
+
+#ifndef _WIN32
+// When a whole read or write must be over; NO_DEADLINE blocks as long as the socket does
+using Deadline = std::chrono::steady_clock::time_point;
+static const Deadline NO_DEADLINE = Deadline::max();
+
+// Waits until fd is ready for `events`; false once the deadline has passed
+inline bool waitReady(int fd, short events, Deadline deadline){
+    if(deadline == NO_DEADLINE) return true;
+    while(true){
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count() + 1;
+        if(left <= 0) return false;
+        pollfd p{fd, events, 0};
+        int ready = ::poll(&p, 1, (int)std::min<long long>(left, INT_MAX));
+        if(ready > 0) return true;
+        if(ready == 0 || errno != EINTR) return false;
+    }
+}
+
+inline bool writeAll(int fd, const char* data, size_t size, Deadline deadline = NO_DEADLINE){
+    int flags = MSG_NOSIGNAL | (deadline == NO_DEADLINE ? 0 : MSG_DONTWAIT);
+    while(size){
+        if(!waitReady(fd, POLLOUT, deadline)) return false;
+        ssize_t n = ::send(fd, data, size, flags);
+        if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+        if(n <= 0) return false;
+        data += n; size -= (size_t)n;
+    }
+    return true;
+}
+
+inline bool writeMessage(int fd, const Message& message, Deadline deadline = NO_DEADLINE){
+    std::string wire;
+    for(auto& field: message) wire += field.first + " " + std::to_string(field.second.size()) + "\n" + field.second + "\n";
+    wire += "end\n";
+    return writeAll(fd, wire.data(), wire.size(), deadline);
+}
+
+// Buffered reads from one connection
+class SocketReader {
+private:
+    int fd;
+    char buffer[1 << 16];
+    size_t pos = 0, len = 0;
+    Deadline deadline = NO_DEADLINE;
+    bool fill(){
+        pos = 0;
+        len = 0;
+        if(!waitReady(fd, POLLIN, deadline)) return false;
+        ssize_t n = ::recv(fd, buffer, sizeof buffer, 0);
+        len = n > 0 ? (size_t)n : 0;
+        return len > 0;
+    }
+public:
+    explicit SocketReader(int socket) : fd(socket) {}
+    // Reads after this fail once `by` has passed, however the peer spaces out its bytes
+    void setDeadline(Deadline by){ deadline = by; }
+    // Whether bytes of a following message are already buffered (a client that pipelines requests)
+    bool buffered() const { return pos < len; }
+    bool readLine(std::string& line){
+        line.clear();
+        while(true){
+            if(pos == len && !fill()) return false;
+            char c = buffer[pos++];
+            if(c == '\n') return true;
+            if(line.size() >= MAX_HEADER_BYTES) return false;
+            line += c;
+        }
+    }
+    bool readBytes(size_t count, std::string& out){
+        out.clear();
+        if(count > MAX_FIELD_BYTES) return false;
+        out.reserve(count);
+        while(out.size() < count){
+            if(pos == len && !fill()) return false;
+            size_t take = std::min(count - out.size(), len - pos);
+            out.append(buffer + pos, take);
+            pos += take;
+        }
+        return true;
+    }
+};
+
+// False on a closed connection, a malformed message or one over the size limits
+inline bool readMessage(SocketReader& reader, Message& message){
+    message.clear();
+    std::string header, value, newline;
+    size_t total = 0;
+    while(reader.readLine(header)){
+        if(header == "end") return true;
+        size_t space = header.rfind(' ');
+        if(space == std::string::npos) return false;
+        size_t size = std::strtoull(header.c_str() + space + 1, nullptr, 10);
+        total += header.size() + 1;
+        if(size > MAX_FIELD_BYTES || size > MAX_MESSAGE_BYTES - std::min(total, MAX_MESSAGE_BYTES)) return false;
+        total += size + 1;
+        if(!reader.readBytes(size, value) || !reader.readBytes(1, newline) || newline != "\n") return false;
+        message[header.substr(0, space)] = value;
+    }
+    return false;
+}
+
+// Connects to a listening banglishd; -1 when nothing listens at the path
+inline int connectSocket(const std::string& path){
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0) return -1;
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof address.sun_path){ ::close(fd); return -1; }
+    path.copy(address.sun_path, path.size());
+    if(::connect(fd, (sockaddr*)&address, sizeof address) != 0){ ::close(fd); return -1; }
+    return fd;
+}
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "ast.h"
+#include "content_hash.h"
+#include "interpreter.h"
+
+// Result of specializing a program for one known input file
+struct Specialization {
+    bool ok = false;
+    std::string note;       // Why the general program was kept, if it was
+    std::string code;       // C++ translation unit: the precomputed run plus the general program as fallback
+    size_t outputBytes = 0;
+    int exitCode = 0;
+    double evalMs = 0;
+};
+
+
+// Partially evaluates the program against `input` at compile time. With every `poro` value known, the whole
+// run folds away: what remains is one write of the output and the `ferot dao` code. The general program is
+// kept behind it (its main renamed) and takes over when the binary is fed anything else, so the specialized
+// build is never wrong, only slow on other inputs. Runs that would hit undefined behaviour or exceed the
+// time or output budget are not specialized.
+inline Specialization specializeForInput(const Program& program, const std::string& generalCode, const std::string& input,
+                                         double budgetMs = 2000, size_t maxOutput = 64u << 20){
+    using clock = std::chrono::steady_clock;
+    struct OverBudget {};
+    Specialization result;
+    const std::string mainLine = "\nint main(){\n";
+    size_t mainAt = generalCode.find(mainLine);
+    if(mainAt == std::string::npos){ result.note = "generated code has no main()"; return result; }
+
+    std::istringstream in(input);
+    std::ostringstream out;
+    Interpreter interpreter(program, in, out);
+    auto start = clock::now();
+    interpreter.checkpoint = [&]{
+        if((size_t)out.tellp() > maxOutput || std::chrono::duration<double, std::milli>(clock::now() - start).count() > budgetMs) throw OverBudget{};
+    };
+    try {
+        result.exitCode = interpreter.run();
+    } catch(const OverBudget&){
+        result.note = "evaluation exceeded its time or output budget";
+        return result;
+    } catch(const InterpreterError& e){
+        result.note = std::string("evaluation stopped at ") + e.what();
+        return result;
+    }
+    result.evalMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    const std::string output = out.str();
+    result.outputBytes = output.size();
+
+    std::string code = generalCode;
+    code.replace(mainAt, mainLine.size(), "\nint bg_general_main(){\n");
+    // main() is the last function; falling off its end means 0, which the renamed copy has to say itself
+    size_t close = code.rfind('}');
+    if(close != std::string::npos) code.insert(close, "return 0;\n");
+    code += "#include <cstdio>\n#include <iterator>\n";
+    code += "static const char bg_known_output[] =";
+    for(size_t i=0; i<output.size() || i==0; i+=96){
+        code += "\n    \"";
+        for(unsigned char c: output.substr(i, 96)){
+            if(c=='"' || c=='\\'){ code += '\\'; code += (char)c; }
+            else if(c=='\n') code += "\\n";
+            else if(c<32 || c>126 || c=='?'){ char b[8]; std::snprintf(b, sizeof b, "\\%03o", c); code += b; }
+            else code += (char)c;
+        }
+        code += "\"";
+    }
+    code += ";\n";
+    // The program recomputes bg::fnv1a over stdin to recognise the known input
+    code += "int main(){\n"
+            "    std::string bg_in((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());\n"
+            "    unsigned long long bg_h = 1469598103934665603ull;\n"
+            "    for(unsigned char c: bg_in){ bg_h ^= c; bg_h *= 1099511628211ull; }\n"
+            "    if(bg_in.size() == " + std::to_string(input.size()) + "u && bg_h == " + std::to_string(bg::fnv1a(input)) + "ull){\n"
+            "        std::fwrite(bg_known_output, 1, sizeof bg_known_output - 1, stdout);\n"
+            "        return " + std::to_string(result.exitCode) + ";\n"
+            "    }\n"
+            "    std::istringstream bg_replay(bg_in);\n"
+            "    std::cin.rdbuf(bg_replay.rdbuf());\n"
+            "    return bg_general_main();\n"
+            "}\n";
+    result.code = std::move(code);
+    result.ok = true;
+    return result;
+}
@@ -9,6 +9,8 @@ struct Symbol {
     int line;
     bool initialized;
     std::string value; // Added value field to store initialization values
+    bool isArray = false;
+    std::string arraySize; // Size expression as written, e.g. "n" or "100"
 };
 
 struct SymbolTable {
@@ -16,7 +18,12 @@ struct SymbolTable {
     std::vector<std::string> order;
     void declare(const std::string& name, const std::string& dtype, int line){
         if(!table.count(name)) order.push_back(name);
-        table[name] = {name,dtype,line,false,""};  // Initialize with empty value
+        table[name] = {name,dtype,line,false,"",false,""};  // Initialize with empty value
+    }
+    void declareArray(const std::string& name, const std::string& dtype, int line, const std::string& size){
+        declare(name,dtype,line);
+        table[name].isArray = true;
+        table[name].arraySize = size;
     }
     void initialize(const std::string& name, const std::string& value = ""){ 
         if(table.count(name)) {
@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "thread_pool.h"
+
+// Runs named tasks on a ThreadPool as soon as all of their dependencies have finished.
+// Tasks become ready in the order they were added, so a one-worker pool reproduces that order.
+class TaskGraph {
+private:
+    struct Node {
+        std::string name;
+        std::function<void()> fn;
+        std::vector<size_t> dependents;
+        size_t waitingOn = 0;
+        double ms = 0;      // Wall time of the last run
+    };
+    std::vector<Node> nodes;
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t done = 0;
+    std::exception_ptr failure;
+
+    void launch(ThreadPool& pool, size_t id) {
+        pool.submit([this, &pool, id] {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                nodes[id].fn();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+            nodes[id].ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::vector<size_t> ready;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t next : nodes[id].dependents) {
+                    if (--nodes[next].waitingOn == 0) ready.push_back(next);
+                }
+                done++;
+                finished.notify_all();
+            }
+            for (size_t next : ready) launch(pool, next);
+        });
+    }
+public:
+    // Adds a task that starts after every task in `deps`; returns its id for later dependencies
+    size_t add(const std::string& name, std::function<void()> fn, const std::vector<size_t>& deps = {}) {
+        nodes.push_back({name, std::move(fn), {}, deps.size(), 0});
+        for (size_t dep : deps) nodes[dep].dependents.push_back(nodes.size() - 1);
+        return nodes.size() - 1;
+    }
+    // Blocks until every task has run; rethrows the first exception a task raised
+    void run(ThreadPool& pool) {
+        std::vector<size_t> roots;
+        for (size_t id = 0; id < nodes.size(); ++id) {
+            if (nodes[id].waitingOn == 0) roots.push_back(id);
+        }
+        for (size_t id : roots) launch(pool, id);
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return done == nodes.size(); });
+        if (failure) std::rethrow_exception(failure);
+    }
+    // Task names with the wall time each took, in the order they were added
+    std::vector<std::pair<std::string, double>> timings() const {
+        std::vector<std::pair<std::string, double>> result;
+        for (const Node& node : nodes) result.push_back({node.name, node.ms});
+        return result;
+    }
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "ast.h"
+#include "interpreter.h"
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Outcome of a tiered run: which tier's output landed in the output file and how long each part took
+struct TierReport {
+    bool handled = false;       // false: tiering unavailable here, run the normal compile + run path
+    std::string tier;           // "interpreter" or "native"
+    std::string note;           // Why the interpreter handed over, if it did
+    int status = 0;             // Exit status in system()/waitpid form
+    bool compiled = false;
+    double interpretMs = 0, compileMs = -1, nativeMs = 0, totalMs = 0;
+    size_t replayedBytes = 0;   // Interpreter output the native binary reproduced before taking over
+};
+
+#ifndef _WIN32
+// Starts `sh -c command` in the background
+inline pid_t spawnShell(const std::string& command){
+    pid_t pid = fork();
+    if(pid == 0){
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+    return pid;
+}
+
+// Runs the compiled program on inputPath and captures its stdout; returns the wait status
+inline int runCaptured(const std::string& executable, const std::string& inputPath, std::string& output){
+    std::string command = "./" + executable + " < " + inputPath;
+    FILE* pipe = popen(command.c_str(), "r");
+    if(!pipe) return -1;
+    char buffer[1 << 16]; size_t n;
+    while((n = fread(buffer, 1, sizeof buffer, pipe)) > 0) output.append(buffer, n);
+    return pclose(pipe);
+}
+#endif
+
+// Interprets the program at once while compileCommand builds executable in the background. When the
+// build finishes first, the binary is rerun from the start on the same input: programs are deterministic,
+// so its output repeats what the interpreter already wrote (which is checked) and then carries on at
+// native speed. The interpreter keeps the run if the binary disagrees. When the interpreter finishes
+// first the build still runs to the end: its status decides whether the program compiles at all (output
+// is only written if it does), and the binary serves later runs of the same code.
+inline TierReport runTiered(const Program& program, const std::string& compileCommand, const std::string& executable,
+                            const std::string& inputPath, const std::string& outputPath){
+    TierReport report;
+#ifndef _WIN32
+    using clock = std::chrono::steady_clock;
+    auto ms = [](clock::time_point a, clock::time_point b){ return std::chrono::duration<double, std::milli>(b - a).count(); };
+    struct SwappedIn {};
+
+    std::ifstream inputFile(inputPath, std::ios::binary);
+    std::istringstream input(std::string((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>()));
+    std::ostringstream produced;
+    std::string nativeOutput;
+
+    auto start = clock::now();
+    pid_t compiler = spawnShell(compileCommand);
+    if(compiler < 0) return report;
+    report.handled = true;
+    bool building = true, swapAllowed = true;
+
+    // Polls the build; returns true once it has finished (successfully or not)
+    auto poll = [&](bool wait){
+        if(!building) return true;
+        int status = 0;
+        if(waitpid(compiler, &status, wait ? 0 : WNOHANG) != compiler) return false;
+        building = false;
+        report.compileMs = ms(start, clock::now());
+        report.compiled = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        return true;
+    };
+    auto runNative = [&]{
+        auto t = clock::now();
+        nativeOutput.clear();
+        report.status = runCaptured(executable, inputPath, nativeOutput);
+        report.nativeMs = ms(t, clock::now());
+    };
+
+    Interpreter interpreter(program, input, produced);
+    interpreter.checkpoint = [&]{
+        if(!swapAllowed || !poll(false)) return;
+        swapAllowed = false;
+        if(!report.compiled) return;
+        report.interpretMs = ms(start, clock::now());
+        runNative();
+        const std::string sofar = produced.str();
+        if(nativeOutput.compare(0, sofar.size(), sofar) == 0){ report.replayedBytes = sofar.size(); throw SwappedIn{}; }
+        report.note = "compiled output diverged from the interpreter; kept interpreting";
+    };
+
+    try {
+        int code = interpreter.run();
+        report.interpretMs = ms(start, clock::now());
+        report.tier = "interpreter";
+        report.status = (code & 0xff) << 8;
+        poll(true);
+        if(report.compiled) std::ofstream(outputPath, std::ios::binary) << produced.str();
+    } catch(const SwappedIn&){
+        report.tier = "native";
+        std::ofstream(outputPath, std::ios::binary) << nativeOutput;
+    } catch(const InterpreterError& e){
+        // The compiled program defines what happens next; wait for it and let it produce the whole output
+        report.interpretMs = ms(start, clock::now());
+        report.note = std::string("interpreter stopped at ") + e.what();
+        poll(true);
+        report.tier = "native";
+        if(report.compiled){
+            runNative();
+            const std::string sofar = produced.str();
+            if(nativeOutput.compare(0, sofar.size(), sofar) == 0) report.replayedBytes = sofar.size();
+            std::ofstream(outputPath, std::ios::binary) << nativeOutput;
+        }
+    }
+    report.totalMs = ms(start, clock::now());
+#endif
+    return report;
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <cctype>
+#include "utf8.h"
 
 struct Token {
     std::string type;
@@ -7,3 +10,37 @@ struct Token {
     int line;
     int col;
 };
+
+// Hand-written recognizers for the lexeme shapes the lexer produces. A `true` answer always agrees
+// with the corresponding validation regex, so callers only fall back to std::regex on `false`. The
+// regexes are byte-wise, so identifiers in Bengali script are only recognized here.
+inline bool isIdentifierShape(std::string_view s){
+    const char* p = s.data(); const char* end = p + s.size();
+    int n = bg::utf8::identStartLength(p, end);
+    if(!n) return false;
+    for(p += n; p < end; p += n) if(!(n = bg::utf8::identCharLength(p, end))) return false;
+    return true;
+}
+// [0-9]+(\.[0-9]+)?
+inline bool isNumberShape(std::string_view s){
+    size_t i=0; while(i<s.size() && isdigit((unsigned char)s[i])) i++;
+    if(i==0) return false;
+    if(i==s.size()) return true;
+    if(s[i]!='.') return false;
+    size_t j=++i; while(i<s.size() && isdigit((unsigned char)s[i])) i++;
+    return i>j && i==s.size();
+}
+// "(?:[^"\\]|\\.)*" with '.' excluding line terminators; `lenientQuotes` accepts (?:\\.|[^"])* instead
+inline bool isStringShape(std::string_view s, bool lenientQuotes = false){
+    if(s.size()<2 || s.front()!='"' || s.back()!='"') return false;
+    for(size_t i=1;i+1<s.size();++i){
+        char c=s[i];
+        if(c=='"') return false;
+        if(c=='\\'){
+            bool escapable = i+2<s.size() && s[i+1]!='\n' && s[i+1]!='\r';
+            if(escapable) i++;
+            else if(!lenientQuotes) return false;
+        }
+    }
+    return true;
+}
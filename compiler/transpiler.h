@@ -4,14 +4,145 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <set>
 #include "token.h"
 #include "symbol_table.h"
+#include "compilation_unit.h"
 
 static std::string trim_str(const std::string&s){ size_t a=s.find_first_not_of(" \t\r\n"); if(a==std::string::npos) return ""; size_t b=s.find_last_not_of(" \t\r\n"); return s.substr(a,b-a+1);}    
 
+// Arrays at or below this many bytes with a literal size stay on the stack; everything else goes to the heap
+static const size_t BG_STACK_ARRAY_BYTES = 16 * 1024;
+
+// Runtime emitted ahead of main() when a heap array is declared: 64-byte aligned storage,
+// trivially constructible element types are left uninitialized so `poro` fills them in one pass
+static const char* BG_ARRAY_RUNTIME = R"(#include <new>
+#include <cstddef>
+#include <type_traits>
+template<class T> struct bg_array {
+    T* p = nullptr; size_t n = 0;
+    explicit bg_array(long long count){
+        n = count > 0 ? (size_t)count : 0;
+        p = static_cast<T*>(::operator new(n * sizeof(T) + 1, std::align_val_t(64)));
+        if(!std::is_trivially_default_constructible<T>::value) for(size_t i=0;i<n;++i) new(p+i) T();
+    }
+    ~bg_array(){
+        if(!std::is_trivially_destructible<T>::value) for(size_t i=0;i<n;++i) p[i].~T();
+        ::operator delete(p, std::align_val_t(64));
+    }
+    bg_array(const bg_array&) = delete;
+    bg_array& operator=(const bg_array&) = delete;
+    T& operator[](size_t i){ return p[i]; }
+};)";
+
+// Bump arena used with --arena: top-level arrays are carved from 64-byte aligned chunks and released together at `ferot dao`
+static const char* BG_ARENA_RUNTIME = R"(struct bg_arena_t {
+    std::vector<std::pair<char*, size_t>> chunks; size_t used = 0;
+    template<class T> T* alloc(long long count){
+        size_t bytes = ((count > 0 ? (size_t)count : 0) * sizeof(T) + 63) & ~(size_t)63;
+        if(chunks.empty() || used + bytes > chunks.back().second){
+            size_t cap = bytes > (1u << 20) ? bytes : (1u << 20);
+            chunks.push_back({static_cast<char*>(::operator new(cap, std::align_val_t(64))), cap}); used = 0;
+        }
+        T* p = reinterpret_cast<T*>(chunks.back().first + used); used += bytes; return p;
+    }
+    void release(){ for(auto& c: chunks) ::operator delete(c.first, std::align_val_t(64)); chunks.clear(); used = 0; }
+    ~bg_arena_t(){ release(); }
+} bg_arena;)";
+
+// A transpiled program cut into translation units that g++ can build in parallel: a shared header with
+// the runtime and the state struct, plus one source per unit. `units` is empty when the program stays whole.
+struct SplitProgram {
+    std::string header;
+    std::vector<std::string> units;
+    std::string note;   // Why the program was not split, if it was not
+};
+
+// Per-line counters for --profile-lines. bg_prof_at() charges the cycles since the previous mark to the line
+// that was running and starts the next one; the destructor writes .generated/line_profile.txt at exit.
+static const char* BG_PROFILE_RUNTIME = R"(#include <chrono>
+#include <cstdio>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+inline unsigned long long bg_prof_clock(){ return __rdtsc(); }
+#else
+inline unsigned long long bg_prof_clock(){ return std::chrono::steady_clock::now().time_since_epoch().count(); }
+#endif
+struct bg_profile_t {
+    unsigned long long count[BG_PROFILE_LINES] = {}, cycles[BG_PROFILE_LINES] = {}, last = bg_prof_clock();
+    int current = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned long long first = last;
+    ~bg_profile_t(){
+        unsigned long long now = bg_prof_clock(); cycles[current] += now - last;
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        FILE* f = std::fopen(".generated/line_profile.txt", "w");
+        if(!f) return;
+        std::fprintf(f, "%.9g\n", now > first ? ns / (double)(now - first) : 0.0);
+        for(int i = 1; i < BG_PROFILE_LINES; ++i) if(count[i]) std::fprintf(f, "%d %llu %llu\n", i, count[i], cycles[i]);
+        std::fclose(f);
+    }
+};
+inline bg_profile_t bg_profile;
+inline void bg_prof_at(int line){
+    unsigned long long now = bg_prof_clock();
+    bg_profile.cycles[bg_profile.current] += now - bg_profile.last;
+    bg_profile.last = now; bg_profile.current = line; bg_profile.count[line]++;
+})";
+
 struct Transpiler {
-    std::vector<Token> toks;
     SymbolTable sym;
+    bool useArena = false;   // Top-level heap arrays come from bg_arena and are freed at `ferot dao`
+    bool needsArrayRuntime = false;
+    unsigned splitUnits = 0; // Above 1, transpile() keeps what split() needs to outline main()
+    bool lineMap = false;    // Emit #line directives so compiler, gdb and perf report main.banglish lines
+    bool profileLines = false; // Count and time every Banglish line, dumped by the program at exit
+    std::string sourceName = "main.banglish";
+    int tickLine = 0;        // Banglish line whose statements are being emitted
+
+    // main() as emitted by the last transpile() when splitUnits > 1, with the top-level facts split() rewrites
+    struct BodyDecl { size_t at; std::string cxxType, name, size, init; bool isArray; };
+    std::vector<std::string> prelude, body;
+    std::vector<BodyDecl> bodyDecls;
+    std::vector<std::pair<size_t, std::string>> bodyReturns;
+
+    static size_t elementSize(const std::string& cxxType){
+        if(cxxType=="int") return 4;
+        if(cxxType=="double") return 8;
+        if(cxxType=="std::string") return 32;
+        return 1;
+    }
+
+    // Literal sizes small enough for the stack keep the plain C++ array; initialized arrays must stay on the stack
+    static bool fitsOnStack(const std::string& cxxType, const std::string& size, const std::string& init){
+        if(!init.empty()) return true;
+        if(size.empty() || size.size() > 9 || !std::all_of(size.begin(), size.end(), [](char c){ return isdigit((unsigned char)c); })) return false;
+        return std::stoull(size) * elementSize(cxxType) <= BG_STACK_ARRAY_BYTES;
+    }
+
+    // Only top-level arrays come from the arena: it is released at `ferot dao`, so one declared in a loop body would grow it every pass
+    std::string declareArray(const std::string& cxxType, const std::string& name, const std::string& size, const std::string& init, bool topLevel){
+        if(fitsOnStack(cxxType, size, init)){
+            std::string stmt = cxxType + " " + name + "[" + size + "]"; if(!init.empty()) stmt += " = " + init; return stmt + ";";
+        }
+        needsArrayRuntime = true;
+        if(useArena && topLevel && cxxType != "std::string") return cxxType + "* " + name + " = bg_arena.alloc<" + cxxType + ">(" + size + ");";
+        return "bg_array<" + cxxType + "> " + name + "(" + size + ");";
+    }
+
+    // With --profile-lines, marks the start of tickLine inside an expression so braceless bodies stay intact
+    std::string tick() const { return profileLines ? "bg_prof_at(" + std::to_string(tickLine) + "), " : ""; }
+    std::string ticked(const std::string& expr) const { return profileLines ? "(" + tick() + expr + ")" : expr; }
+    // Plain expression statements passed through from the source; declarations and jumps cannot take a tick
+    static bool isExpressionStatement(const std::string& L){
+        static const std::set<std::string> skip = {"int","double","char","bool","string","std","auto","long","float","unsigned",
+                                                   "const","break","continue","return","else","if","for","while","do"};
+        if(L.empty() || L.back()!=';' || !(bg::utf8::isIdentLeadByte(L[0]) || L[0]=='+' || L[0]=='-' || L[0]=='(')) return false;
+        size_t e = 0; while(e<L.size() && bg::utf8::isIdentByte(L[e])) ++e;
+        return !skip.count(L.substr(0, e));
+    }
+
+    static std::string baseName(const std::string& var){ return trim_str(var.substr(0, var.find('['))); }
 
     static std::string mapType(const std::string& kw){
         if(kw=="purno sonkha") return "int";
@@ -49,8 +180,8 @@ struct Transpiler {
         }
     }
 
-    std::string transpile(const std::string& source){
-        std::stringstream in(source); std::string line; std::vector<std::string> out;
+    std::string transpile(const CompilationUnit& unit){
+        std::vector<std::string> out;
         out.push_back("#include <iostream>");
         out.push_back("#include <string>");
         out.push_back("#include <vector>");
@@ -59,13 +190,21 @@ struct Transpiler {
         out.push_back("#include <unordered_map>");
         out.push_back("#include <set>");
         out.push_back("using namespace std;");
+        size_t runtimeAt = out.size();
         out.push_back("int main(){");
+        const size_t bodyAt = out.size();
+        bool keepBody = splitUnits > 1;
+        prelude.clear(); body.clear(); bodyDecls.clear(); bodyReturns.clear();
+        size_t scanned = bodyAt; int depth = 0;  // Brace depth inside main() after out[scanned-1]
+        auto topLevel = [&]{ for(; scanned < out.size(); ++scanned) depth += braceDelta(out[scanned]); return depth == 0; };
 
         int lineNo=0;
-        while(std::getline(in,line)){
-            lineNo++; std::string L = trim_str(line);
+        for(size_t li=0; li<unit.lineCount(); ++li){
+            lineNo++; std::string L(trim_view(unit.line(li)));
             if(L.empty()) continue;
             if(L=="shuru" || L=="shesh") continue;
+            tickLine = lineNo;
+            if(lineMap) out.push_back("#line " + std::to_string(lineNo) + " \"" + sourceName + "\"");
             while(!L.empty() && L[0]=='}'){ out.push_back("}"); L = trim_str(L.substr(1)); }
             if(L.empty()) continue;
 
@@ -78,8 +217,19 @@ struct Transpiler {
                 else{ name = trim_str(rest.substr(0,eq)); init = trim_str(rest.substr(eq+1)); }
                 if(!name.empty() && name.back()==';') name.pop_back();
                 if(!init.empty() && init.back()==';') init.pop_back();
+                size_t lb = name.find('[');
+                if(lb!=std::string::npos && name.back()==']'){
+                    std::string size = trim_str(name.substr(lb+1, name.size()-lb-2)); name = trim_str(name.substr(0,lb));
+                    sym.declareArray(name,cxxType,lineNo,size);
+                    if(!init.empty()) sym.initialize(name, init);
+                    if(!fitsOnStack(cxxType,size,init)) size = ticked(size);
+                    if(keepBody) bodyDecls.push_back({out.size()-bodyAt, cxxType, name, size, init, true});
+                    out.push_back(declareArray(cxxType,name,size,init,topLevel())); return true;
+                }
                 if(!name.empty()) sym.declare(name,cxxType,lineNo);
                 if(!init.empty()) sym.initialize(name, init); // Pass the initialization value
+                if(!init.empty() && init.find(',')==std::string::npos) init = ticked(init);
+                if(keepBody) bodyDecls.push_back({out.size()-bodyAt, cxxType, name, "", init, false});
                 std::string stmt = cxxType + " " + name; if(!init.empty()) stmt += " = " + init; stmt += ";"; out.push_back(stmt); return true; };
 
             if(L.rfind("purno sonkha",0)==0){ if(handleDecl("purno sonkha")) continue; }
@@ -93,23 +243,30 @@ struct Transpiler {
                 if(lp!=std::string::npos && rp!=std::string::npos && rp>lp){
                     std::string var = trim_str(L.substr(lp+1, rp-lp-1));
                     if(!var.empty() && var.back()==';') var.pop_back();
-                    sym.initialize(var, "user_input"); // Mark as initialized with user input
-                    std::string type=""; if(sym.table.count(var)) type = sym.table[var].dtype;
+                    std::string base = baseName(var);
+                    sym.initialize(base, "user_input"); // Mark as initialized with user input
+                    std::string type=""; if(sym.table.count(base)) type = sym.table[base].dtype;
                     std::string stmt; if(type=="std::string") stmt = "getline(cin >> ws, "+var+");"; else stmt = "cin >> "+var+";";
-                    out.push_back(stmt); continue; }
+                    out.push_back(tick() + stmt); continue; }
             }
 
             if(L.rfind("dekhao",0)==0){
                 std::string inside = trim_str(L.substr(std::string("dekhao").size()));
                 if(!inside.empty() && inside[0]==' ') inside = trim_str(inside);
                 if(!inside.empty() && inside.back()==';') inside.pop_back();
-                out.push_back(renderDekhao(inside)); continue; }
+                out.push_back(tick() + renderDekhao(inside)); continue; }
 
-            if(L.rfind("jodi",0)==0){ std::string rest = trim_str(L.substr(4)); out.push_back("if " + rest); continue; }
-            if(L.rfind("nahoy jodi",0)==0){ std::string rest = trim_str(L.substr(std::string("nahoy jodi").size())); out.push_back("else if " + rest); continue; }
+            auto tickCondition = [&](const std::string& rest){ return profileLines && !rest.empty() && rest[0]=='(' ? "(" + tick() + rest.substr(1) : rest; };
+            if(L.rfind("jodi",0)==0){ std::string rest = trim_str(L.substr(4)); out.push_back("if " + tickCondition(rest)); continue; }
+            if(L.rfind("nahoy jodi",0)==0){ std::string rest = trim_str(L.substr(std::string("nahoy jodi").size())); out.push_back("else if " + tickCondition(rest)); continue; }
             if(L.rfind("nahoy",0)==0 && L.rfind("nahoy jodi",0)!=0){ std::string rest = trim_str(L.substr(std::string("nahoy").size())); if(rest.empty()) out.push_back("else"); else out.push_back(std::string("else ") + rest); continue; }
 
-            if(L.rfind("ferot dao",0)==0){ std::string expr = trim_str(L.substr(std::string("ferot dao").size())); if(!expr.empty() && expr.back()==';') expr.pop_back(); out.push_back("return " + expr + ";"); continue; }
+            if(L.rfind("ferot dao",0)==0){ std::string expr = trim_str(L.substr(std::string("ferot dao").size())); if(!expr.empty() && expr.back()==';') expr.pop_back();
+                expr = ticked(expr);
+                if(keepBody) bodyReturns.push_back({out.size()-bodyAt, expr});
+                if(useArena) out.push_back("{ int bg_ret = " + expr + "; bg_arena.release(); return bg_ret; }");
+                else out.push_back("return " + expr + ";");
+                continue; }
 
             if(L.rfind("loop",0)==0){ 
                 std::string X=L; X = std::string("for") + L.substr(4);
@@ -121,14 +278,176 @@ struct Transpiler {
                     std::vector<std::pair<std::string,std::string>> types = {{"purno sonkha","int"},{"dosomik sonkha","double"},{"lekha","std::string"},{"akkhor","char"},{"sotto-mittha","bool"},{"int","int"},{"double","double"},{"std::string","std::string"},{"char","char"},{"bool","bool"}};
                     for(auto &p: types){ const std::string& t=p.first; const std::string& cxx=p.second; if(init.rfind(t,0)==0){ std::string rest = trim_str(init.substr(t.size())); if(!rest.empty() && rest[0]==' ') rest = trim_str(rest); std::string name = rest; std::string value = ""; size_t eq = rest.find('='); if(eq!=std::string::npos){ name = trim_str(rest.substr(0,eq)); value = trim_str(rest.substr(eq+1)); } if(!name.empty()){ sym.declare(name,cxx,lineNo); if(!value.empty()) sym.initialize(name, value); } break; } }
                 }
+                if(profileLines){
+                    size_t c = X.find(';', X.find('('));
+                    size_t cond = c==std::string::npos ? c : X.find_first_not_of(' ', c+1);
+                    if(cond!=std::string::npos) X.insert(cond, tick() + (X[cond]==';' ? "true" : ""));
+                }
                 out.push_back(X); continue; 
             }
 
-            { size_t eq = L.find('='); if(eq!=std::string::npos){ std::string lhs = trim_str(L.substr(0,eq)); std::string rhs = trim_str(L.substr(eq+1)); if(!rhs.empty() && rhs.back()==';') rhs.pop_back(); if(!lhs.empty() && isalpha((unsigned char)lhs[0])){ sym.initialize(lhs, rhs); } } }
-            out.push_back(L);
+            { size_t eq = L.find('='); if(eq!=std::string::npos){ std::string lhs = trim_str(L.substr(0,eq)); std::string rhs = trim_str(L.substr(eq+1)); if(!rhs.empty() && rhs.back()==';') rhs.pop_back(); if(!lhs.empty() && (isalpha((unsigned char)lhs[0]) || (unsigned char)lhs[0]>=0x80)){ sym.initialize(lhs, rhs); } } }
+            out.push_back(isExpressionStatement(L) ? tick() + L : L);
         }
+        if(keepBody) body.assign(out.begin()+bodyAt, out.end());
         out.push_back("}");
+        if(needsArrayRuntime || useArena){
+            std::vector<std::string> rt = {BG_ARRAY_RUNTIME};
+            if(useArena) rt.push_back(BG_ARENA_RUNTIME);
+            out.insert(out.begin() + runtimeAt, rt.begin(), rt.end());
+        }
+        if(profileLines){
+            std::string rt = BG_PROFILE_RUNTIME;
+            for(size_t at; (at = rt.find("BG_PROFILE_LINES")) != std::string::npos; ) rt.replace(at, 16, std::to_string(lineNo + 1));
+            out.insert(out.begin() + runtimeAt, rt);
+        }
+        if(keepBody) prelude.assign(out.begin(), out.begin() + (out.size() - body.size() - 2));
         std::string code; for(auto&s:out){ code += s + "\n"; }
         return code;
     }
+    // Net '{' minus '}' on an emitted line, ignoring string and char literals and // comments
+    static int braceDelta(const std::string& line){
+        int d = 0;
+        for(size_t i=0;i<line.size();++i){
+            char c = line[i];
+            if(c=='"' || c=='\''){ for(++i; i<line.size() && line[i]!=c; ++i) if(line[i]=='\\') ++i; }
+            else if(c=='/' && i+1<line.size() && line[i+1]=='/') break;
+            else if(c=='{') ++d;
+            else if(c=='}') --d;
+        }
+        return d;
+    }
+
+    // True when an initializer only holds literals, so it can move into the state struct unchanged
+    static bool isConstantInit(const std::string& init){
+        for(size_t i=0;i<init.size();++i){
+            char c = init[i];
+            if(c=='"' || c=='\''){ for(++i; i<init.size() && init[i]!=c; ++i) if(init[i]=='\\') ++i; continue; }
+            if(!bg::utf8::isIdentLeadByte(c)) continue;
+            size_t j = i; while(j<init.size() && bg::utf8::isIdentByte(init[j])) ++j;
+            bool inNumber = i>0 && (isdigit((unsigned char)init[i-1]) || init[i-1]=='.');
+            std::string word = init.substr(i, j-i);
+            if(!inNumber && word!="true" && word!="false") return false;
+            i = j-1;
+        }
+        return true;
+    }
+
+    // Splits a declaration's declarators at commas outside brackets and literals: "a = f(1, 2), b" -> {"a = f(1, 2)", "b"}
+    static std::vector<std::string> declarators(const std::string& text){
+        std::vector<std::string> parts(1);
+        int nesting = 0;
+        for(size_t i=0;i<text.size();++i){
+            char c = text[i];
+            if(c=='"' || c=='\''){
+                size_t j = i;
+                for(++j; j<text.size() && text[j]!=c; ++j) if(text[j]=='\\') ++j;
+                parts.back() += text.substr(i, j-i+1); i = j; continue;
+            }
+            if(c=='(' || c=='[' || c=='{') ++nesting;
+            else if(c==')' || c==']' || c=='}') --nesting;
+            if(c==',' && nesting==0){ parts.emplace_back(); continue; }
+            parts.back() += c;
+        }
+        for(auto& p: parts) p = trim_str(p);
+        return parts;
+    }
+
+    // Outlines main() from the last transpile() into member functions of one state struct: top-level variables
+    // become members (declarations turn into assignments), `ferot dao` returns through bg_exit_code, and runs of
+    // top-level statements are cut into functions spread over at most splitUnits sources. Member functions see
+    // the variables unqualified, so statement lines are copied as they are.
+    SplitProgram split() const {
+        SplitProgram result;
+        const size_t minLines = 200;   // Smallest function worth a cut; smaller programs stay whole
+        size_t n = body.size();
+        std::vector<int> depth(n + 1, 0);  // depth[i]: nesting before body line i
+        for(size_t i=0;i<n;++i){
+            depth[i+1] = depth[i] + braceDelta(body[i]);
+            if(depth[i+1] < 0){ result.note = "unbalanced braces"; return result; }
+        }
+        if(depth[n] != 0){ result.note = "unbalanced braces"; return result; }
+
+        std::vector<std::string> lines = body, members;
+        for(const BodyDecl& d: bodyDecls){
+            if(depth[d.at] != 0) continue;
+            std::string& line = lines[d.at];
+            if(!d.isArray){
+                // `purno sonkha a = 1, b;` declares each name as a member and keeps each initializer as an assignment
+                line = "";
+                for(const std::string& part: declarators(d.init.empty() ? d.name : d.name + " = " + d.init)){
+                    size_t eq = part.find('=');
+                    std::string name = trim_str(part.substr(0, eq));
+                    if(name.find('[')!=std::string::npos){ result.note = "array `" + baseName(name) + "` is declared alongside other names"; return result; }
+                    members.push_back(d.cxxType + " " + name + ";");
+                    if(eq!=std::string::npos) line += (line.empty() ? "" : " ") + name + " = " + trim_str(part.substr(eq+1)) + ";";
+                }
+            } else if(fitsOnStack(d.cxxType, d.size, d.init)){
+                if(d.size.empty() || !std::all_of(d.size.begin(), d.size.end(), [](char c){ return isdigit((unsigned char)c); }) || !isConstantInit(d.init)){
+                    result.note = "array `" + d.name + "` needs a literal size and constant initializer"; return result;
+                }
+                members.push_back(line); line = "";
+            } else if(useArena && d.cxxType != "std::string"){
+                members.push_back(d.cxxType + "* " + d.name + " = nullptr;");
+                line = d.name + " = bg_arena.alloc<" + d.cxxType + ">(" + d.size + ");";
+            } else {
+                members.push_back("bg_array<" + d.cxxType + "> " + d.name + "{0};");
+                line = "bg_rebind(" + d.name + ", " + d.size + ");";
+            }
+        }
+        for(auto& r: bodyReturns){
+            if(useArena) lines[r.first] = "{ bg_exit_code = " + r.second + "; bg_arena.release(); return true; }";
+            else lines[r.first] = "{ bg_exit_code = " + r.second + "; return true; }";
+        }
+
+        // A cut may follow a finished top-level statement that no `else` continues
+        auto cuttable = [&](size_t i){
+            if(depth[i+1] != 0) return false;
+            const std::string& t = body[i];
+            if(t.back()!=';' && t.back()!='}') return false;
+            for(size_t j=i+1;j<n;++j){ if(body[j].empty() || body[j][0]=='#') continue; return body[j].rfind("else",0)!=0; }
+            return true;
+        };
+        size_t target = std::max(minLines, n / (splitUnits * 4) + 1);
+        std::vector<size_t> starts = {0};
+        for(size_t i=0, run=0; i+1<n; ++i){
+            if(++run >= target && cuttable(i)){ starts.push_back(i+1); run = 0; }
+        }
+        if(starts.size() < 2){ result.note = n < 2*minLines ? "program too small to split" : "no top-level statement to cut at"; return result; }
+
+        // Consecutive functions share a source so each unit holds about the same number of lines
+        std::vector<std::string> units;
+        for(size_t f=0, last=0; f<starts.size(); ++f){
+            size_t u = std::min<size_t>(starts[f] * splitUnits / n, splitUnits - 1);
+            if(units.empty() || u != last) units.push_back("#include \"bg_program.h\"\n");
+            last = u;
+            std::string& src = units.back();
+            src += "bool bg_state::bg_part_" + std::to_string(f) + "(){\n";
+            size_t end = f+1<starts.size() ? starts[f+1] : n;
+            for(size_t i=starts[f]; i<end; ++i) if(!lines[i].empty()) src += lines[i] + "\n";
+            src += "return false;\n}\n";
+        }
+
+        std::string header = "#pragma once\n";
+        for(const std::string& p: prelude){
+            std::string s = p;
+            size_t arena = s.rfind("} bg_arena;");
+            if(arena != std::string::npos) s.replace(arena, 11, "};\ninline bg_arena_t bg_arena;");
+            header += s + "\n";
+        }
+        if(needsArrayRuntime)
+            header += "template<class T> void bg_rebind(bg_array<T>& a, long long count){ a.~bg_array<T>(); new(&a) bg_array<T>(count); }\n";
+        header += "struct bg_state {\nint bg_exit_code = 0;\n";
+        for(const std::string& m: members) header += m + "\n";
+        for(size_t f=0; f<starts.size(); ++f) header += "bool bg_part_" + std::to_string(f) + "();\n";
+        header += "};\n";
+
+        std::string entry = "#include <memory>\nint main(){\nstd::unique_ptr<bg_state> bg_s(new bg_state);\n";
+        for(size_t f=0; f<starts.size(); ++f) entry += "if(bg_s->bg_part_" + std::to_string(f) + "()) return bg_s->bg_exit_code;\n";
+        entry += "return 0;\n}\n";
+        units.front() += entry;
+        result.header = header;
+        result.units = std::move(units);
+        return result;
+    }
 };
@@ -0,0 +1,216 @@
+#pragma once
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BG_UTF8_SIMD 1
+#endif
+
+// UTF-8 for the lexer: whole-source validation (SSSE3/AVX2 with a scalar fallback), code point
+// decoding, the Bengali identifier classes, and SSE2 scans over ASCII identifier and blank runs.
+namespace bg::utf8 {
+
+// Length of the well-formed sequence at p (shortest form, no surrogates, at most U+10FFFF) and its
+// code point, or 0 when the bytes at p are not valid UTF-8
+inline int decode(const char* s, const char* end, char32_t& cp){
+    const unsigned char* p = (const unsigned char*)s;
+    size_t n = end - s;
+    if(n==0) return 0;
+    unsigned char b = p[0];
+    if(b<0x80){ cp = b; return 1; }
+    int len; char32_t min;
+    if(b>=0xC2 && b<=0xDF){ len = 2; cp = b & 0x1F; min = 0x80; }
+    else if(b>=0xE0 && b<=0xEF){ len = 3; cp = b & 0x0F; min = 0x800; }
+    else if(b>=0xF0 && b<=0xF4){ len = 4; cp = b & 0x07; min = 0x10000; }
+    else return 0;
+    if(n<(size_t)len) return 0;
+    for(int k=1;k<len;++k){
+        if((p[k] & 0xC0)!=0x80) return 0;
+        cp = (cp<<6) | (p[k] & 0x3F);
+    }
+    if(cp<min || cp>0x10FFFF || (cp>=0xD800 && cp<=0xDFFF)) return 0;
+    return len;
+}
+
+inline bool validScalar(const char* s, size_t n){
+    const char* end = s + n;
+    while(s<end){
+        uint64_t word;
+        if(end-s>=8 && (std::memcpy(&word, s, 8), (word & 0x8080808080808080ull)==0)){ s += 8; continue; }
+        char32_t cp;
+        int len = decode(s, end, cp);
+        if(!len) return false;
+        s += len;
+    }
+    return true;
+}
+
+#ifdef BG_UTF8_SIMD
+// Keiser-Lemire lookup validation: three nibble tables classify every (previous byte, byte) pair, and
+// 3- and 4-byte leads are checked two and three bytes on. Blocks without a high bit only have to
+// confirm that the previous block did not end mid-sequence.
+enum : uint8_t {
+    TOO_SHORT = 1<<0, TOO_LONG = 1<<1, OVERLONG_3 = 1<<2, TOO_LARGE = 1<<3, SURROGATE = 1<<4,
+    OVERLONG_2 = 1<<5, TOO_LARGE_1000 = 1<<6, OVERLONG_4 = 1<<6, TWO_CONTS = 1<<7,
+    CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS
+};
+inline constexpr uint8_t BYTE1_HIGH[16] = {TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, TOO_SHORT | OVERLONG_2, TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE, TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4};
+inline constexpr uint8_t BYTE1_LOW[16] = {CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY,
+    CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000};
+inline constexpr uint8_t BYTE2_HIGH[16] = {TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT};
+
+__attribute__((target("ssse3"))) inline bool validSsse3(const char* s, size_t n){
+    const __m128i byte1High = _mm_loadu_si128((const __m128i*)BYTE1_HIGH), byte1Low = _mm_loadu_si128((const __m128i*)BYTE1_LOW);
+    const __m128i byte2High = _mm_loadu_si128((const __m128i*)BYTE2_HIGH);
+    const __m128i nibble = _mm_set1_epi8(0x0F), high = _mm_set1_epi8((char)0x80);
+    const __m128i maxValue = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xEF, (char)0xDF, (char)0xBF);
+    __m128i error = _mm_setzero_si128(), prev = _mm_setzero_si128(), incomplete = _mm_setzero_si128();
+    char tail[16] = {};
+    for(size_t i=0; i<n; i+=16){
+        __m128i in;
+        if(n-i>=16) in = _mm_loadu_si128((const __m128i*)(s+i));
+        else { std::memcpy(tail, s+i, n-i); in = _mm_loadu_si128((const __m128i*)tail); }
+        if(_mm_movemask_epi8(in)==0){ error = _mm_or_si128(error, incomplete); incomplete = _mm_setzero_si128(); prev = in; continue; }
+        __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+        __m128i special = _mm_and_si128(_mm_and_si128(
+            _mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+            _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+        __m128i third = _mm_subs_epu8(_mm_alignr_epi8(in, prev, 14), _mm_set1_epi8((char)(0xE0 - 0x80)));
+        __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(in, prev, 13), _mm_set1_epi8((char)(0xF0 - 0x80)));
+        error = _mm_or_si128(error, _mm_xor_si128(_mm_and_si128(_mm_or_si128(third, fourth), high), special));
+        incomplete = _mm_subs_epu8(in, maxValue);
+        prev = in;
+    }
+    error = _mm_or_si128(error, incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+__attribute__((target("avx2"))) inline bool validAvx2(const char* s, size_t n){
+    const __m256i byte1High = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)BYTE1_HIGH));
+    const __m256i byte1Low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)BYTE1_LOW));
+    const __m256i byte2High = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)BYTE2_HIGH));
+    const __m256i nibble = _mm256_set1_epi8(0x0F), high = _mm256_set1_epi8((char)0x80);
+    const __m256i maxValue = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xEF, (char)0xDF, (char)0xBF);
+    __m256i error = _mm256_setzero_si256(), prev = _mm256_setzero_si256(), incomplete = _mm256_setzero_si256();
+    char tail[32] = {};
+    for(size_t i=0; i<n; i+=32){
+        __m256i in;
+        if(n-i>=32) in = _mm256_loadu_si256((const __m256i*)(s+i));
+        else { std::memcpy(tail, s+i, n-i); in = _mm256_loadu_si256((const __m256i*)tail); }
+        if(_mm256_movemask_epi8(in)==0){ error = _mm256_or_si256(error, incomplete); incomplete = _mm256_setzero_si256(); prev = in; continue; }
+        // Bytes 1..3 back across the lane boundary: the upper lane of prev joined to the lower lane of in
+        __m256i carried = _mm256_permute2x128_si256(prev, in, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(in, carried, 15);
+        __m256i special = _mm256_and_si256(_mm256_and_si256(
+            _mm256_shuffle_epi8(byte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(byte2High, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble)));
+        __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(in, carried, 14), _mm256_set1_epi8((char)(0xE0 - 0x80)));
+        __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(in, carried, 13), _mm256_set1_epi8((char)(0xF0 - 0x80)));
+        error = _mm256_or_si256(error, _mm256_xor_si256(_mm256_and_si256(_mm256_or_si256(third, fourth), high), special));
+        incomplete = _mm256_subs_epu8(in, maxValue);
+        prev = in;
+    }
+    error = _mm256_or_si256(error, incomplete);
+    return _mm256_testz_si256(error, error);
+}
+#endif
+
+// True when the whole of s is well-formed UTF-8; picks the widest vector unit the CPU has
+inline bool valid(std::string_view s){
+#ifdef BG_UTF8_SIMD
+    static const int level = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("ssse3") ? 1 : 0;
+    if(level==2) return validAvx2(s.data(), s.size());
+    if(level==1) return validSsse3(s.data(), s.size());
+#endif
+    return validScalar(s.data(), s.size());
+}
+
+// Bengali block letters (and avagraha, khanda ta, the Assamese ra/wa) may start an identifier; vowel
+// signs, virama, nukta, digits and ZWNJ/ZWJ (which select conjunct forms) may continue one
+inline bool isBengaliLetter(char32_t c){
+    return (c>=0x0985 && c<=0x09B9) || c==0x09BD || c==0x09CE || (c>=0x09DC && c<=0x09E1) || c==0x09F0 || c==0x09F1 || c==0x09FC;
+}
+inline bool isBengaliIdentChar(char32_t c){
+    return isBengaliLetter(c) || (c>=0x0981 && c<=0x0983) || (c>=0x09BC && c<=0x09D7) || (c>=0x09E2 && c<=0x09EF)
+        || c==0x09FE || c==0x200C || c==0x200D;
+}
+// Byte length of the identifier-start (or identifier-continue) code point at p, 0 when there is none
+inline int identStartLength(const char* p, const char* end){
+    if(p>=end) return 0;
+    unsigned char b = *p;
+    if(b<0x80) return isalpha(b) || b=='_' ? 1 : 0;
+    char32_t cp; int len = decode(p, end, cp);
+    return len && isBengaliLetter(cp) ? len : 0;
+}
+inline int identCharLength(const char* p, const char* end){
+    if(p>=end) return 0;
+    unsigned char b = *p;
+    if(b<0x80) return isalnum(b) || b=='_' ? 1 : 0;
+    char32_t cp; int len = decode(p, end, cp);
+    return len && isBengaliIdentChar(cp) ? len : 0;
+}
+// For scans over text the lexer has already accepted: any byte of a multi-byte sequence is taken to
+// be part of a (Bengali) identifier
+inline bool isIdentByte(char c){ return isalnum((unsigned char)c) || c=='_' || (unsigned char)c>=0x80; }
+inline bool isIdentLeadByte(char c){ return isalpha((unsigned char)c) || c=='_' || (unsigned char)c>=0x80; }
+
+// Code points in s (continuation bytes are not counted); columns and report widths use this
+inline size_t length(std::string_view s){
+    size_t n = 0;
+    for(char c: s) n += ((unsigned char)c & 0xC0)!=0x80;
+    return n;
+}
+
+// Count of leading [A-Za-z0-9_] bytes, and of leading ' '/'\t' bytes, 16 at a time
+inline size_t asciiIdentRun(const char* p, const char* end){
+    const char* start = p;
+#ifdef BG_UTF8_SIMD
+    const __m128i before0 = _mm_set1_epi8('0' - 1), after9 = _mm_set1_epi8('9' + 1);
+    const __m128i beforeA = _mm_set1_epi8('a' - 1), afterZ = _mm_set1_epi8('z' + 1);
+    const __m128i lower = _mm_set1_epi8(0x20), underscore = _mm_set1_epi8('_');
+    while(end-p>=16){
+        __m128i in = _mm_loadu_si128((const __m128i*)p);
+        __m128i folded = _mm_or_si128(in, lower);
+        // Signed compares: bytes >= 0x80 are negative and fall outside every range
+        __m128i ok = _mm_or_si128(_mm_or_si128(
+            _mm_and_si128(_mm_cmpgt_epi8(in, before0), _mm_cmplt_epi8(in, after9)),
+            _mm_and_si128(_mm_cmpgt_epi8(folded, beforeA), _mm_cmplt_epi8(folded, afterZ))),
+            _mm_cmpeq_epi8(in, underscore));
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(ok) & 0xFFFF;
+        if(mask) return p - start + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while(p<end && (isalnum((unsigned char)*p) || *p=='_')) ++p;
+    return p - start;
+}
+inline size_t blankRun(const char* p, const char* end){
+    const char* start = p;
+#ifdef BG_UTF8_SIMD
+    const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+    while(end-p>=16){
+        __m128i in = _mm_loadu_si128((const __m128i*)p);
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(in, space), _mm_cmpeq_epi8(in, tab))) & 0xFFFF;
+        if(mask) return p - start + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while(p<end && (*p==' ' || *p=='\t')) ++p;
+    return p - start;
+}
+
+}
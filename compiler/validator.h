@@ -1,67 +1,182 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <regex>
 #include <unordered_set>
 #include "token.h"
+#include "compilation_unit.h"
 
 namespace bg {
 
-inline std::vector<std::string> validateTokens(const std::vector<Token>& toks){
-    std::vector<std::string> errors;
-    std::regex reIdent(R"(^[A-Za-z_]\w*$)");
-    std::regex reNumber(R"(^\d+(?:\.\d+)?$)");
-    std::regex reString(R"(^"(?:\\.|[^"])*"$)");
-    std::regex reOp(R"(^(\+\+|--|\+=|-=|\*=|/=|<=|>=|==|!=|&&|\|\||[+*/%<>=!&|(){};,\[\]-])$)");
+// Findings written to output_validation.txt: token errors first, then line errors
+struct ValidationReport {
+    std::vector<std::string> tokenErrors;
+    std::vector<std::string> lineErrors;
+    bool ok() const { return tokenErrors.empty() && lineErrors.empty(); }
+};
 
-    const std::unordered_set<std::string> kw = {
+// Patterns and tables are static: compiled once per process and shared read-only across threads
+struct TokenValidator {
+    static inline const std::regex reIdent{R"(^[A-Za-z_]\w*$)"};
+    static inline const std::regex reNumber{R"(^\d+(?:\.\d+)?$)"};
+    static inline const std::regex reString{R"(^"(?:\\.|[^"])*"$)"};
+    static inline const std::regex reOp{R"(^(\+\+|--|\+=|-=|\*=|/=|<=|>=|==|!=|&&|\|\||[+*/%<>=!&|(){};,\[\]-])$)"};
+
+    static inline const std::unordered_set<std::string> kw = {
         "shuru","shesh","lekha","akkhor","sotto-mittha","jodi","nahoy","poro","dekhao","loop",
         "purno sonkha","dosomik sonkha","ferot dao","nahoy jodi"
     };
+    // Exactly the strings reOp accepts
+    static inline const std::unordered_set<std::string> ops = {
+        "++","--","+=","-=","*=","/=","<=",">=","==","!=","&&","||",
+        "+","*","/","%","<",">","=","!","&","|","(",")","{","}",";",",","[","]","-"
+    };
 
-    for(const auto& t: toks){
-        if(t.type == "EOF") continue;
+    // Appends an error for `t` if its lexeme does not fit its type
+    void check(const Token& t, std::vector<std::string>& errors) const {
+        if(t.type == "EOF") return;
         const std::string &lex = t.lexeme;
         bool ok = true;
-        if(t.type == "IDENT") ok = std::regex_match(lex, reIdent);
-        else if(t.type == "NUMBER") ok = std::regex_match(lex, reNumber);
-        else if(t.type == "STRING") ok = std::regex_match(lex, reString);
-        else if(t.type == "OP") ok = std::regex_match(lex, reOp);
+        if(t.type == "IDENT") ok = isIdentifierShape(lex) || std::regex_match(lex, reIdent);
+        else if(t.type == "NUMBER") ok = isNumberShape(lex) || std::regex_match(lex, reNumber);
+        else if(t.type == "STRING") ok = isStringShape(lex, true) || std::regex_match(lex, reString);
+        else if(t.type == "OP") ok = ops.count(lex) > 0 || std::regex_match(lex, reOp);
         else if(t.type == "KEYWORD") ok = kw.count(lex) > 0;
         if(!ok){
             errors.push_back("Token error at line " + std::to_string(t.line) + ", col " + std::to_string(t.col) + ": '" + lex + "' invalid for type " + t.type);
         }
     }
+};
+
+inline std::vector<std::string> validateTokens(const std::vector<Token>& toks){
+    TokenValidator validator;
+    std::vector<std::string> errors;
+    for(const auto& t: toks) validator.check(t, errors);
     return errors;
 }
 
-inline std::vector<std::string> validateLines(const std::string& source){
-    auto trim = [](const std::string& s){ size_t a=s.find_first_not_of(" \t\r\n"); if(a==std::string::npos) return std::string(); size_t b=s.find_last_not_of(" \t\r\n"); return s.substr(a,b-a+1); };
-    std::regex reDecl(R"(^(purno sonkha|dosomik sonkha|lekha|akkhor|sotto-mittha)\s+[A-Za-z_]\w*(?:\s*\[\s*[^\]]+\s*\])?(?:\s*=\s*[^;]+)?\s*;\s*$)");
-    std::regex reInput(R"(^poro\s*\(\s*[^)]+\)\s*;?\s*$)");
-    std::regex rePrint(R"(^dekhao\s+.+;?\s*$)");
-    std::regex reIf(R"(^jodi\s*\(.*\)\s*\{?\s*$)");
-    std::regex reIfInline(R"(^jodi\s*\(.*\)\s*\{.*\}\s*$)");
-    std::regex reElseIf(R"(^nahoy jodi\s*\(.*\)\s*\{?\s*$)");
-    std::regex reElseIfInline(R"(^nahoy jodi\s*\(.*\)\s*\{.*\}\s*$)");
-    std::regex reElse(R"(^nahoy(?:\s*\{?\s*)?$)");
-    std::regex reReturn(R"(^ferot dao\s+[^;]+\s*;?\s*$)");
-    std::regex reLoop(R"(^loop\s*\(.*;.*;.*\)\s*\{?\s*$)");
-    std::regex reOnlyOpen(R"(^\{\s*$)");
-    std::regex reOnlyClose(R"(^\}\s*$)");
-    std::regex reAssign(R"(^\s*(?:\+\+|--)?\s*[A-Za-z_]\w*(?:\s*\[\s*[^\]]+\s*\])?\s*(?:\+\+|--|=(?:[^;]+)|\+=\s*[^;]+|-=\s*[^;]+|\*=\s*[^;]+|/=\s*[^;]+|%=\s*[^;]+)?\s*;?\s*$)");
+struct LineValidator {
+    static inline const std::regex reDecl{R"(^(purno sonkha|dosomik sonkha|lekha|akkhor|sotto-mittha)\s+[A-Za-z_]\w*(?:\s*\[\s*[^\]]+\s*\])?(?:\s*=\s*[^;]+)?\s*;\s*$)"};
+    static inline const std::regex reInput{R"(^poro\s*\(\s*[^)]+\)\s*;?\s*$)"};
+    static inline const std::regex rePrint{R"(^dekhao\s+.+;?\s*$)"};
+    static inline const std::regex reIf{R"(^jodi\s*\(.*\)\s*\{?\s*$)"};
+    static inline const std::regex reIfInline{R"(^jodi\s*\(.*\)\s*\{.*\}\s*$)"};
+    static inline const std::regex reElseIf{R"(^nahoy jodi\s*\(.*\)\s*\{?\s*$)"};
+    static inline const std::regex reElseIfInline{R"(^nahoy jodi\s*\(.*\)\s*\{.*\}\s*$)"};
+    static inline const std::regex reElse{R"(^nahoy(?:\s*\{?\s*)?$)"};
+    static inline const std::regex reReturn{R"(^ferot dao\s+[^;]+\s*;?\s*$)"};
+    static inline const std::regex reLoop{R"(^loop\s*\(.*;.*;.*\)\s*\{?\s*$)"};
+    static inline const std::regex reOnlyOpen{R"(^\{\s*$)"};
+    static inline const std::regex reOnlyClose{R"(^\}\s*$)"};
+    static inline const std::regex reAssign{R"(^\s*(?:\+\+|--)?\s*[A-Za-z_]\w*(?:\s*\[\s*[^\]]+\s*\])?\s*(?:\+\+|--|=(?:[^;]+)|\+=\s*[^;]+|-=\s*[^;]+|\*=\s*[^;]+|/=\s*[^;]+|%=\s*[^;]+)?\s*;?\s*$)"};
 
-    std::vector<std::string> errors;
-    std::stringstream ss(source); std::string line; int ln=0;
-    while(std::getline(ss, line)){
-        ++ln; std::string L = trim(line);
-        if(L.empty()) continue;
-        if(L=="shuru" || L=="shesh") continue;
-        while(!L.empty() && L[0]=='}'){
-            L = trim(L.substr(1));
+    static bool isWs(char c){ return c==' ' || c=='\t'; }
+    static size_t skipWs(std::string_view L, size_t i){ while(i<L.size() && isWs(L[i])) i++; return i; }
+    static bool startsWith(std::string_view L, std::string_view p){ return L.substr(0, p.size()) == p; }
+    static bool onlyWsFrom(std::string_view L, size_t i){ return skipWs(L, i) == L.size(); }
+    static size_t skipIdent(std::string_view L, size_t i){
+        const char* end = L.data() + L.size();
+        int n = i<L.size() ? utf8::identStartLength(L.data()+i, end) : 0;
+        if(!n) return std::string_view::npos;
+        for(i+=n; i<L.size() && (n = utf8::identCharLength(L.data()+i, end)); i+=n) {}
+        return i;
+    }
+    // \s*\[\s*[^\]]+\s*\] ; returns i unchanged when there is no subscript, npos when it is malformed
+    static size_t skipSubscript(std::string_view L, size_t i){
+        size_t j = skipWs(L, i);
+        if(j>=L.size() || L[j]!='[') return i;
+        size_t close = L.find(']', j+1);
+        if(close==std::string_view::npos || close==j+1) return std::string_view::npos;
+        return close+1;
+    }
+    // [^;]+ then \s*;?\s*$ : at least one character before the first ';', only blanks after it
+    static bool restUntilSemicolon(std::string_view L, size_t i){
+        size_t semi = L.find(';', i);
+        if(semi==std::string_view::npos) return i<L.size();
+        return semi>i && onlyWsFrom(L, semi+1);
+    }
+    // `kw \s*\( .* \) \s*\{?\s*$`, optionally requiring two ';' inside the parentheses
+    static bool headerShape(std::string_view L, std::string_view kw, int semicolons){
+        if(!startsWith(L, kw)) return false;
+        size_t lp = skipWs(L, kw.size());
+        if(lp>=L.size() || L[lp]!='(') return false;
+        std::string_view tail = L;
+        if(!tail.empty() && tail.back()=='{') tail.remove_suffix(1);
+        while(!tail.empty() && isWs(tail.back())) tail.remove_suffix(1);
+        if(tail.size()<=lp+1 || tail.back()!=')') return false;
+        int found = 0;
+        for(size_t k=lp+1;k+1<tail.size() && found<semicolons;++k) if(tail[k]==';') found++;
+        return found>=semicolons;
+    }
+
+    // Conservative recognizer for the common statement shapes; `true` implies one of the regexes
+    // matches, `false` means "ask the regexes"
+    static bool fastMatch(std::string_view L){
+        if(L.find('\r')!=std::string_view::npos) return false;
+        if(L=="{") return true;
+        if(startsWith(L, "dekhao")) return L.size()>7 && isWs(L[6]);
+        if(startsWith(L, "poro")){
+            size_t lp = skipWs(L, 4);
+            if(lp>=L.size() || L[lp]!='(') return false;
+            size_t rp = L.find(')', lp+1);
+            if(rp==std::string_view::npos || rp==lp+1) return false;
+            size_t k = skipWs(L, rp+1);
+            if(k<L.size() && L[k]==';') k++;
+            return onlyWsFrom(L, k);
         }
-        if(L.empty()) continue;
-        bool match =
+        for(std::string_view kw: {"purno sonkha","dosomik sonkha","lekha","akkhor","sotto-mittha"}){
+            if(!startsWith(L, kw)) continue;
+            if(L.size()<=kw.size() || !isWs(L[kw.size()])) return false;
+            size_t k = skipIdent(L, skipWs(L, kw.size()));
+            if(k==std::string_view::npos) return false;
+            k = skipSubscript(L, k);
+            if(k==std::string_view::npos) return false;
+            k = skipWs(L, k);
+            if(k<L.size() && L[k]=='=') return restUntilSemicolon(L, k+1) && L.find(';', k+1)!=std::string_view::npos;
+            return k<L.size() && L[k]==';' && onlyWsFrom(L, k+1);
+        }
+        if(headerShape(L, "jodi", 0) || headerShape(L, "nahoy jodi", 0) || headerShape(L, "loop", 2)) return true;
+        if(startsWith(L, "nahoy")){
+            size_t k = skipWs(L, 5);
+            if(k<L.size() && L[k]=='{') k++;
+            return onlyWsFrom(L, k);
+        }
+        if(startsWith(L, "ferot dao")){
+            if(L.size()<=9 || !isWs(L[9])) return false;
+            std::string_view r = L.substr(9);
+            if(r.back()==';') r.remove_suffix(1);
+            return r.size()>=2 && r.find(';')==std::string_view::npos;
+        }
+        size_t k = 0;
+        if(startsWith(L, "++") || startsWith(L, "--")) k = 2;
+        k = skipIdent(L, skipWs(L, k));
+        if(k==std::string_view::npos) return false;
+        k = skipSubscript(L, k);
+        if(k==std::string_view::npos) return false;
+        k = skipWs(L, k);
+        if(k<L.size() && L[k]=='=') return restUntilSemicolon(L, k+1);
+        if(k+1<L.size() && L[k+1]=='=' && std::string_view("+-*/%").find(L[k])!=std::string_view::npos) return restUntilSemicolon(L, k+2);
+        if(startsWith(L.substr(k), "++") || startsWith(L.substr(k), "--")) k += 2;
+        k = skipWs(L, k);
+        if(k<L.size() && L[k]==';') k++;
+        return onlyWsFrom(L, k);
+    }
+
+    // The regexes work on bytes: each Bengali identifier character stands in as '_' for them
+    static std::string asciiShape(const std::string& L){
+        std::string shape;
+        const char* p = L.data(); const char* end = p + L.size();
+        while(p<end){
+            int n = (unsigned char)*p>=0x80 ? utf8::identCharLength(p, end) : 0;
+            if(n){ shape += '_'; p += n; }
+            else shape += *p++;
+        }
+        return shape;
+    }
+
+    bool regexMatch(const std::string& L) const {
+        return
             std::regex_match(L, reDecl) ||
             std::regex_match(L, reInput) ||
             std::regex_match(L, rePrint) ||
@@ -75,10 +190,29 @@ inline std::vector<std::string> validateLines(const std::string& source){
             std::regex_match(L, reOnlyOpen) ||
             std::regex_match(L, reOnlyClose) ||
             std::regex_match(L, reAssign);
-        if(!match){
+    }
+
+    // Classifies source line `ln` (1-based); appends an error when no statement shape fits
+    void check(int ln, std::string_view line, std::vector<std::string>& errors) const {
+        std::string_view V = trim_view(line);
+        if(V.empty()) return;
+        if(V=="shuru" || V=="shesh") return;
+        while(!V.empty() && V[0]=='}'){
+            V = trim_view(V.substr(1));
+        }
+        if(V.empty()) return;
+        if(fastMatch(V)) return;
+        std::string L(V);
+        if(!regexMatch(asciiShape(L))){
             errors.push_back("Line " + std::to_string(ln) + " not recognized: " + L);
         }
     }
+};
+
+inline std::vector<std::string> validateLines(const CompilationUnit& unit){
+    LineValidator validator;
+    std::vector<std::string> errors;
+    for(size_t li=0; li<unit.lineCount(); ++li) validator.check((int)li+1, unit.line(li), errors);
     return errors;
 }
 
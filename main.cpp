@@ -3,8 +3,35 @@
 #include "compiler/banglish.h"
 #include "compiler/validator.h"
 #include "compiler/parser.h"
+#include "compiler/frontend.h"
+#include "compiler/parallel_lexer.h"
+#include "compiler/task_graph.h"
+#include "compiler/codegen_x86.h"
+#include "compiler/codegen_c.h"
+#include "compiler/tiered.h"
+#include "compiler/specializer.h"
+#include "compiler/analysis_cache.h"
+#include "compiler/bench.h"
+#include "compiler/repl.h"
+#include <filesystem>
+#include <optional>
+#include <thread>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 using namespace std;
 
+// Left-aligns text in a report column; widths count code points so Bengali names line up
+string padRight(const string& text, size_t width) {
+    return text + string(width - min(width, bg::utf8::length(text)), ' ');
+}
+
 // Writes a table of unique tokens with types and lexemes in 4 columns to output_tokens.txt
 void writeTokenTable(const vector<Token>& tokens) {
     ofstream file("output_tokens.txt");
@@ -37,10 +64,10 @@ void writeTokenTable(const vector<Token>& tokens) {
     for(size_t i = 0; i < uniqueTokens.size(); ++i) {
         if(i % 2 == 0) { // Left side (first pair)
             typeWidth1 = max(typeWidth1, uniqueTokens[i].first.size());
-            lexemeWidth1 = max(lexemeWidth1, uniqueTokens[i].second.size());
+            lexemeWidth1 = max(lexemeWidth1, bg::utf8::length(uniqueTokens[i].second));
         } else { // Right side (second pair)
             typeWidth2 = max(typeWidth2, uniqueTokens[i].first.size());
-            lexemeWidth2 = max(lexemeWidth2, uniqueTokens[i].second.size());
+            lexemeWidth2 = max(lexemeWidth2, bg::utf8::length(uniqueTokens[i].second));
         }
     }
     
@@ -53,7 +80,7 @@ void writeTokenTable(const vector<Token>& tokens) {
     };
     
     auto printCell = [&](const string& text, size_t width) {
-        file << ' ' << left << setw(width) << text << ' ';
+        file << ' ' << padRight(text, width) << ' ';
     };
     
     // Print table
@@ -112,11 +139,8 @@ void writeTokenTable(const vector<Token>& tokens) {
     printBorder();
 }
 
-// Writes symbol table (name, type, line, initialized, value) to output_symbol_table.txt
-void writeSymbolTable(const SymbolTable& symbolTable) {
-    ofstream file("output_symbol_table.txt");
-    vector<Symbol> symbols = symbolTable.all();
-    
+// Writes symbol table (name, type, line, initialized, value) as a bordered text table
+void writeSymbolTable(const vector<Symbol>& symbols, ostream& file) {
     // Column widths
     size_t nameWidth = max(size_t(15), string("Name").size());
     size_t typeWidth = max(size_t(15), string("Type").size());
@@ -125,12 +149,15 @@ void writeSymbolTable(const SymbolTable& symbolTable) {
     size_t valueWidth = max(size_t(15), string("Value").size());
     
     // Calculate actual required widths
+    auto displayType = [](const Symbol& symbol) {
+        return symbol.isArray ? symbol.dtype + "[" + symbol.arraySize + "]" : symbol.dtype;
+    };
     for(const auto& symbol : symbols) {
-        nameWidth = max(nameWidth, symbol.name.size());
-        typeWidth = max(typeWidth, symbol.dtype.size());
+        nameWidth = max(nameWidth, bg::utf8::length(symbol.name));
+        typeWidth = max(typeWidth, bg::utf8::length(displayType(symbol)));
         lineWidth = max(lineWidth, to_string(symbol.line).size());
         initWidth = max(initWidth, size_t(3)); // "yes" or "no"
-        valueWidth = max(valueWidth, symbol.value.empty() ? size_t(5) : symbol.value.size()); // "N/A" or actual value
+        valueWidth = max(valueWidth, symbol.value.empty() ? size_t(5) : bg::utf8::length(symbol.value)); // "N/A" or actual value
     }
     
     auto printBorder = [&]() {
@@ -142,7 +169,7 @@ void writeSymbolTable(const SymbolTable& symbolTable) {
     };
     
     auto printCell = [&](const string& text, size_t width) {
-        file << ' ' << left << setw(width) << text << ' ';
+        file << ' ' << padRight(text, width) << ' ';
     };
     
     // Print table
@@ -157,7 +184,7 @@ void writeSymbolTable(const SymbolTable& symbolTable) {
     
     for(const auto& symbol : symbols) {
         file << '|'; printCell(symbol.name, nameWidth);
-        file << '|'; printCell(symbol.dtype, typeWidth);
+        file << '|'; printCell(displayType(symbol), typeWidth);
         file << '|'; printCell(to_string(symbol.line), lineWidth);
         file << '|'; printCell(symbol.initialized ? "yes" : "no", initWidth);
         file << '|'; printCell(symbol.value.empty() ? "N/A" : symbol.value, valueWidth);
@@ -167,6 +194,61 @@ void writeSymbolTable(const SymbolTable& symbolTable) {
     printBorder();
 }
 
+void writeSymbolTable(const vector<Symbol>& symbols) {
+    ofstream file("output_symbol_table.txt");
+    writeSymbolTable(symbols, file);
+}
+
+// Turns the counters a --profile-lines program dumped at exit into output_profile.txt: Banglish lines by
+// self time (the cycles from a line starting until the next one starts), with counts and the source text
+bool writeLineProfile(const CompilationUnit& unit) {
+    ifstream raw(".generated/line_profile.txt");
+    double nsPerCycle = 0;
+    if (!(raw >> nsPerCycle)) return false;
+    struct Hit { int line; unsigned long long count, cycles; };
+    vector<Hit> hits;
+    unsigned long long totalCycles = 0;
+    for (Hit h; raw >> h.line >> h.count >> h.cycles; ) {
+        if (h.line < 1 || (size_t)h.line > unit.lineCount()) continue;
+        hits.push_back(h);
+        totalCycles += h.cycles;
+    }
+    stable_sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.cycles > b.cycles; });
+
+    ofstream file("output_profile.txt");
+    vector<string> headers = {"Line", "Count", "Time (ms)", "Time %", "Banglish source"};
+    vector<vector<string>> rows;
+    for (const Hit& h : hits) {
+        ostringstream ms, pct;
+        ms << fixed << setprecision(3) << h.cycles * nsPerCycle / 1e6;
+        pct << fixed << setprecision(1) << (totalCycles ? 100.0 * h.cycles / totalCycles : 0.0);
+        rows.push_back({to_string(h.line), to_string(h.count), ms.str(), pct.str(), string(trim_view(unit.line(h.line - 1)))});
+    }
+    vector<size_t> widths;
+    for (const string& header : headers) widths.push_back(header.size());
+    for (const auto& row : rows) {
+        for (size_t c = 0; c < row.size(); ++c) widths[c] = max(widths[c], bg::utf8::length(row[c]));
+    }
+    auto printBorder = [&]() {
+        for (size_t width : widths) file << '+' << string(width + 2, '-');
+        file << "+\n";
+    };
+    auto printRow = [&](const vector<string>& row) {
+        for (size_t c = 0; c < row.size(); ++c) {
+            if (c + 1 < row.size()) file << "| " << right << setw(widths[c]) << row[c] << ' ';
+            else file << "| " << padRight(row[c], widths[c]) << ' ';
+        }
+        file << "|\n";
+    };
+    printBorder();
+    printRow(headers);
+    printBorder();
+    for (const auto& row : rows) printRow(row);
+    printBorder();
+    file << "Total: " << fixed << setprecision(3) << totalCycles * nsPerCycle / 1e6 << " ms over " << hits.size() << " line(s)\n";
+    return true;
+}
+
 // Reads the entire source file into a string
 string readSourceFile(const string& filename) {
     ifstream file(filename);
@@ -177,115 +259,788 @@ string readSourceFile(const string& filename) {
     return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
 }
 
-// Validates tokens and lines, writes OK or issues to output_validation.txt
-void writeValidation(const vector<Token>& tokens, const string& source) {
+// Writes OK or the token and line issues to output_validation.txt
+void writeValidation(const bg::ValidationReport& report) {
     ofstream file("output_validation.txt");
-    auto tokenErrors = bg::validateTokens(tokens);
-    auto lineErrors = bg::validateLines(source);
-    
-    if (tokenErrors.empty() && lineErrors.empty()) {
+    if (report.ok()) {
         file << "OK\n";
     } else {
-        for (const auto& error : tokenErrors) {
+        for (const auto& error : report.tokenErrors) {
             file << error << "\n";
         }
-        for (const auto& error : lineErrors) {
+        for (const auto& error : report.lineErrors) {
             file << error << "\n";
         }
     }
 }
 
-// Chooses a compiler command (cl or g++) for the current platform
-string getCompilerCommand(const string& sourceFile, const string& outputFile) {
+// Chooses a compiler command (cl or g++) for the current platform; C sources from --backend=c get
+// cl /TC, gcc or cc instead and are linked with the native runtime. Extra g++ flags go after -O2.
+string getCompilerCommand(const string& sourceFile, const string& outputFile, const string& cRuntime = "", const string& flags = "") {
+    if (!cRuntime.empty()) {
+#ifdef _WIN32
+        if (system("where cl >nul 2>nul") == 0) {
+            return "cl /nologo /O2 /TC \"" + sourceFile + "\" \"" + cRuntime + "\" /Fe:" + outputFile;
+        }
+        return "gcc -std=c99 -O2 -o \"" + outputFile + "\" \"" + sourceFile + "\" \"" + cRuntime + "\"";
+#else
+        return "cc -std=c99 -O2 -o \"" + outputFile + "\" \"" + sourceFile + "\" \"" + cRuntime + "\"";
+#endif
+    }
 #ifdef _WIN32
     if (system("where cl >nul 2>nul") == 0) {
         return "cl /nologo /EHsc /std:c++17 \"" + sourceFile + "\" /Fe:" + outputFile;
     } else if (system("where g++ >nul 2>nul") == 0) {
-        return "g++ -std=c++17 -O2 -o \"" + outputFile + "\" \"" + sourceFile + "\"";
+        return "g++ -std=c++17 -O2" + flags + " -o \"" + outputFile + "\" \"" + sourceFile + "\"";
     } else {
         cerr << "Error: No C++ compiler found (cl or g++)\n";
         exit(2);
     }
 #else
-    return "g++ -std=c++17 -O2 -o \"" + outputFile + "\" \"" + sourceFile + "\"";
+    return "g++ -std=c++17 -O2" + flags + " -o \"" + outputFile + "\" \"" + sourceFile + "\"";
 #endif
 }
 
-int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-    
-    // Read Banglish source
-    string source = readSourceFile("main.banglish");
-    
-    // Lex: tokenize source
-    Lexer lexer(source);
-    lexer.lex();
-    
-    // Parse + validate (writes error_log.txt)
-    ErrorLogger errorLogger("error_log.txt");
-    BanglishParser parser(lexer.tokens, errorLogger);
-    parser.parse();
-    errorLogger.writeLog();
-    
-    // Report status to console
-    if (errorLogger.hasErrors()) {
-        cerr << "Compilation failed with " << errorLogger.getErrorCount() << " error(s)";
-        if (errorLogger.hasWarnings()) {
-            cerr << " and " << errorLogger.getWarningCount() << " improvement(s)";
-        }
-        cerr << ". See error_log.txt for details.\n";
-    } else if (errorLogger.hasWarnings()) {
-        cout << "Compilation successful with " << errorLogger.getWarningCount() 
-             << " improvement(s). See error_log.txt for details.\n";
+// Builds the units of a split program at the same time, one compiler per unit, then links them
+string getSplitCompilerCommand(const vector<string>& sources, const string& outputFile, const string& flags = "") {
+    string command;
+#ifdef _WIN32
+    if (system("where cl >nul 2>nul") == 0) {
+        command = "cl /nologo /EHsc /std:c++17 /MP";
+        for (const string& source : sources) command += " \"" + source + "\"";
+        return command + " /Fe:" + outputFile;
+    }
+    command = "g++ -std=c++17 -O2" + flags + " -o \"" + outputFile + "\"";
+    for (const string& source : sources) command += " \"" + source + "\"";
+    return command;
+#else
+    string objects, waits;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        string object = sources[i].substr(0, sources[i].size() - 4) + ".o", pid = "p" + to_string(i);
+        command += "g++ -std=c++17 -O2" + flags + " -c -o \"" + object + "\" \"" + sources[i] + "\" & " + pid + "=$!; ";
+        waits += "wait $" + pid + " || s=1; ";
+        objects += " \"" + object + "\"";
+    }
+    return command + "s=0; " + waits + "[ $s = 0 ] && g++" + flags + " -o \"" + outputFile + "\"" + objects;
+#endif
+}
+
+// Assembles the native backend's program.s and links it against the prebuilt runtime object
+string getNativeBuildCommand(const string& asmFile, const string& runtimeObject, const string& outputFile) {
+    string objectFile = asmFile.substr(0, asmFile.size() - 2) + ".o";
+    return "as -o \"" + objectFile + "\" \"" + asmFile + "\" && cc -o \"" + outputFile + "\" \"" + objectFile + "\" \"" + runtimeObject + "\"";
+}
+
+// Writes the native runtime and returns what to link against: an object compiled once and reused while
+// the source is unchanged, or the source itself where no cc is available. Empty if the build failed.
+string prepareNativeRuntime() {
+    string sourceFile = ".generated/bg_runtime.c", objectFile = ".generated/bg_runtime.o";
+    ifstream existing(sourceFile);
+    string current((istreambuf_iterator<char>(existing)), istreambuf_iterator<char>());
+    bool unchanged = current == BG_NATIVE_RUNTIME;
+    if (!unchanged) ofstream(sourceFile) << BG_NATIVE_RUNTIME;
+#ifdef _WIN32
+    return sourceFile;
+#else
+    if (unchanged && ifstream(objectFile).good()) return objectFile;
+    string command = "cc -O2 -c -o \"" + objectFile + "\" \"" + sourceFile + "\"";
+    return system(command.c_str()) == 0 ? objectFile : "";
+#endif
+}
+
+// Prints which tier produced output.txt; a failed build fails the run as it would without --tiered
+void reportTier(const TierReport& tier) {
+    if (!tier.compiled) {
+        cerr << "Error: Compilation of transpiled code failed\n";
+        return;
+    }
+    cout << fixed << setprecision(1);
+    if (tier.tier == "interpreter") {
+        cout << "Tier: interpreter produced the output in " << tier.interpretMs << " ms (build finished after "
+             << tier.compileMs << " ms, kept for the next run)\n";
     } else {
-        cout << "Compilation successful with no errors or improvements.\n";
+        cout << "Tier: native binary produced the output (build " << tier.compileMs << " ms, run " << tier.nativeMs
+             << " ms, took over after " << tier.interpretMs << " ms in the interpreter with "
+             << tier.replayedBytes << " bytes of output replayed)\n";
     }
-    
-    // Transpile Banglish -> C++
-    Transpiler transpiler;
-    transpiler.toks = lexer.tokens;
-    string cppCode = transpiler.transpile(source);
-    
-    // Write validation, tokens, symbols
-    writeValidation(lexer.tokens, source);
-    writeTokenTable(lexer.tokens);
-    writeSymbolTable(transpiler.sym);
+    if (!tier.note.empty()) cout << "Tier note: " << tier.note << "\n";
+    cout.unsetf(ios::floatfield);
+    if (tier.status != 0) cerr << "Program exited with code " << tier.status << "\n";
+}
+
+// Profile-guided build from --pgo: where the profile lives and what training cost
+struct PgoBuild {
+    bool built = false;
+    bool cached = false;       // Profile reused from an earlier run with the same source and inputs
+    size_t trainingRuns = 0;
+    double trainingMs = -1;    // Instrumented binary over all training inputs
+    string profileDir;
+};
+
+// Training inputs for --pgo: input.txt, or every file of the --pgo=DIR directory in name order
+vector<string> pgoTrainingInputs(const string& dir) {
+    if (dir.empty()) return {"input.txt"};
+    vector<string> inputs;
+    error_code ec;
+    for (const auto& entry : filesystem::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file()) inputs.push_back(entry.path().string());
+    }
+    sort(inputs.begin(), inputs.end());
+    return inputs;
+}
+
+string getRunCommand(const string& executable, const string& input, const string& output) {
+#ifdef _WIN32
+    return "\"" + executable + "\" < \"" + input + "\" > " + output;
+#else
+    return "./" + executable + " < \"" + input + "\" > " + output;
+#endif
+}
+
+// Builds with -fprofile-generate, runs the binary on every training input, then rebuilds with -fprofile-use.
+// The profile is cached under .generated/pgo/<hash of the C++ source and training inputs>, so later runs of
+// an unchanged program go straight to the optimized build.
+PgoBuild buildWithProfile(const string& sourceKey, const vector<string>& inputs,
+                          const function<string(const string&)>& command, const string& executable) {
+    PgoBuild pgo;
+    string key = sourceKey;
+    for (const string& input : inputs) key += "\n" + readSourceFile(input);
+    pgo.profileDir = ".generated/pgo/" + bg::hexName(bg::fnv1a(key));
+    pgo.trainingRuns = inputs.size();
+    string timingFile = pgo.profileDir + "/training_ms.txt";
+    pgo.cached = bool(ifstream(timingFile) >> pgo.trainingMs);
+    if (!pgo.cached) {
+        filesystem::remove_all(pgo.profileDir);
+        filesystem::create_directories(pgo.profileDir);
+        if (system(command(" -fprofile-generate=" + pgo.profileDir).c_str()) != 0) return pgo;
+#ifdef _WIN32
+        const string discard = "nul";
+#else
+        const string discard = "/dev/null";
+#endif
+        auto start = chrono::steady_clock::now();
+        for (const string& input : inputs) system(getRunCommand(executable, input, discard).c_str());
+        pgo.trainingMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        ofstream(timingFile) << pgo.trainingMs;
+    }
+    string useFlags = " -fprofile-use=" + pgo.profileDir + " -fprofile-correction -Wno-missing-profile";
+    pgo.built = system(command(useFlags).c_str()) == 0;
+    return pgo;
+}
+
+// --bench: runs the built program again under the configured pin and limits and prints the spread of its
+// times. The numbers are compared with the baseline file (written by the first benchmark, or by --bench-save),
+// so a slower binary from a newer compiler shows up. Returns true on a regression beyond the tolerance.
+bool benchmarkProgram(const BenchConfig& config, const string& executable, const string& builtCode) {
+    ifstream inputFile("input.txt", ios::binary);
+    BenchResult result = runBenchmark(executable, "input.txt", config);
+    result.codeHash = bg::hexName(bg::fnv1a(builtCode));
+    result.inputHash = bg::hexName(bg::fnv1a(string((istreambuf_iterator<char>(inputFile)), istreambuf_iterator<char>())));
+    if (!result.ran) {
+        cerr << "Note: benchmark stopped (" << result.note << ")\n";
+        return false;
+    }
+    cout << fixed << setprecision(2) << "Benchmark: " << result.runs << " run" << (result.runs == 1 ? "" : "s") << " after "
+         << config.warmup << " warmup, " << (result.pinnedCpu >= 0 ? "pinned to CPU " + to_string(result.pinnedCpu) : string("unpinned"));
+    if (config.cpuSeconds) cout << ", CPU limit " << config.cpuSeconds << " s";
+    if (config.memoryMb) cout << ", memory limit " << config.memoryMb << " MB";
+    cout << "\n" << padRight("", 9) << setw(10) << "mean" << setw(10) << "median" << setw(10) << "p95" << setw(10) << "stddev" << "\n";
+    for (auto row : {make_pair("wall ms", result.wall), make_pair("user ms", result.user), make_pair("sys ms", result.sys)}) {
+        cout << padRight(row.first, 9) << setw(10) << row.second.mean << setw(10) << row.second.median
+             << setw(10) << row.second.p95 << setw(10) << row.second.stddev << "\n";
+    }
+    cout << "peak RSS " << result.maxRssKb / 1024 << " MB | page faults per run " << setprecision(1)
+         << result.minorFaults << " minor, " << result.majorFaults << " major\n" << setprecision(2);
+    if (!result.note.empty()) cout << "Note: " << result.note << "\n";
+
+    bool regressed = false;
+    BenchResult baseline;
+    if (!config.saveBaseline && loadBenchBaseline(config.baselinePath, baseline)) {
+        auto change = [](double before, double after) { return before > 0 ? (after - before) / before * 100 : 0.0; };
+        double wallChange = change(baseline.wall.median, result.wall.median);
+        cout << "Baseline " << config.baselinePath << " (" << (baseline.codeHash == result.codeHash ? "same code" : "generated code changed")
+             << "): median wall " << baseline.wall.median << " -> " << result.wall.median << " ms (" << showpos << wallChange
+             << "%), user " << noshowpos << baseline.user.median << " -> " << result.user.median << " ms (" << showpos
+             << change(baseline.user.median, result.user.median) << "%), peak RSS " << noshowpos << baseline.maxRssKb / 1024
+             << " -> " << result.maxRssKb / 1024 << " MB\n";
+        // Slower by more than the tolerance and by more than the two runs' noise, so a jittery machine does not cry wolf
+        double noise = 2 * sqrt(baseline.wall.stddev * baseline.wall.stddev + result.wall.stddev * result.wall.stddev);
+        if (baseline.inputHash != result.inputHash) {
+            cout << "Note: input.txt differs from the baseline's, not judging the change\n";
+        } else if (wallChange > config.tolerance && result.wall.median - baseline.wall.median > noise) {
+            cerr << fixed << setprecision(1) << "Regression: median wall time is " << wallChange << "% above the baseline (tolerance "
+                 << config.tolerance << "%)\n";
+            cerr.unsetf(ios::floatfield);
+            regressed = true;
+        }
+    } else {
+        ofstream(config.baselinePath) << benchJson(result);
+        cout << "Baseline " << (config.saveBaseline ? "saved to " : "created at ") << config.baselinePath << "\n";
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    return regressed;
+}
+
+// Command-line switches understood by the driver
+struct DriverOptions {
+    bool useArena = false;  // --arena: top-level heap arrays share one arena released at `ferot dao`
+    bool fused = false;     // --fused: lex, structure checks and validation in a single sweep
+    unsigned jobs = 1;      // --jobs=N: worker threads for the parallel phases
+    string backend = "cpp"; // --backend=cpp|c|x86: code generator used for the program
+    bool tiered = false;    // --tiered: interpret while the binary builds, switch over when it is ready
+    unsigned split = 1;     // --split=N: outline main() into up to N translation units built in parallel
+    bool lineMap = false;   // --line-map: #line directives back to main.banglish and -g, for gdb and perf
+    bool profileLines = false; // --profile-lines: per-line counters and timers, reported in output_profile.txt
+    bool specialize = false; // --specialize: precompute the run on input.txt, keep the program as fallback
+    bool pgo = false;       // --pgo[=DIR]: profile-guided g++ build trained on input.txt or each file in DIR
+    string pgoInputs;
+    bool watch = false;     // --watch: rebuild when main.banglish or input.txt change, redoing only what they affect
+    bool fresh = false;     // --fresh: analyze the source even when .generated/main.bgc already holds the results
+    bool bench = false;     // --bench[=N]: time N more runs of the program and compare them with a stored baseline
+    BenchConfig benchConfig;
+    bool repl = false;      // --repl: run statements as they are typed, keeping variables between them
+};
+
+DriverOptions parseOptions(int argc, char** argv) {
+    DriverOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--arena") options.useArena = true;
+        else if (arg == "--fused") options.fused = true;
+        else if (arg.rfind("--jobs=", 0) == 0) options.jobs = max(1, atoi(arg.c_str() + 7));
+        else if (arg.rfind("--split=", 0) == 0) options.split = max(1, atoi(arg.c_str() + 8));
+        else if (arg == "--tiered") options.tiered = true;
+        else if (arg == "--line-map") options.lineMap = true;
+        else if (arg == "--profile-lines") options.profileLines = true;
+        else if (arg == "--specialize") options.specialize = true;
+        else if (arg == "--pgo") options.pgo = true;
+        else if (arg.rfind("--pgo=", 0) == 0) { options.pgo = true; options.pgoInputs = arg.substr(6); }
+        else if (arg == "--watch") options.watch = true;
+        else if (arg == "--fresh") options.fresh = true;
+        else if (arg == "--bench") options.bench = true;
+        else if (arg.rfind("--bench=", 0) == 0) { options.bench = true; options.benchConfig.runs = max(1, atoi(arg.c_str() + 8)); }
+        else if (arg.rfind("--bench-warmup=", 0) == 0) options.benchConfig.warmup = max(0, atoi(arg.c_str() + 15));
+        else if (arg.rfind("--bench-cpu=", 0) == 0) options.benchConfig.cpu = atoi(arg.c_str() + 12);
+        else if (arg.rfind("--bench-cpu-limit=", 0) == 0) options.benchConfig.cpuSeconds = max(0, atoi(arg.c_str() + 18));
+        else if (arg.rfind("--bench-mem-limit=", 0) == 0) options.benchConfig.memoryMb = max(0, atoi(arg.c_str() + 18));
+        else if (arg.rfind("--bench-baseline=", 0) == 0) options.benchConfig.baselinePath = arg.substr(17);
+        else if (arg.rfind("--bench-tolerance=", 0) == 0) options.benchConfig.tolerance = max(0.0, atof(arg.c_str() + 18));
+        else if (arg == "--bench-save") options.benchConfig.saveBaseline = true;
+        else if (arg == "--repl") options.repl = true;
+        else if (arg == "--backend=cpp" || arg == "--backend=c" || arg == "--backend=x86") options.backend = arg.substr(10);
+        else {
+            cerr << "Unknown option: " << arg << "\n";
+            exit(1);
+        }
+    }
+    return options;
+}
+
+// Prints one watch-mode rebuild as "[reason] lex 0.4 ms | ... | compile skipped | run 3.1 ms"; negative times mark skipped phases
+void printPhaseTimes(const vector<pair<string, double>>& times, const string& reason) {
+    double total = 0;
+    cout << fixed << setprecision(1) << "[" << reason << "]";
+    for (size_t i = 0; i < times.size(); ++i) {
+        cout << (i ? " | " : " ") << times[i].first;
+        if (times[i].second < 0) cout << " skipped";
+        else {
+            cout << " " << times[i].second << " ms";
+            total += times[i].second;
+        }
+    }
+    cout << " | total " << total << " ms" << endl;
+    cout.unsetf(ios::floatfield);
+}
+
+// What the previous --watch rebuild left behind, so the next one redoes only the phases whose inputs changed
+struct WatchState {
+    bool sourceChanged = true;  // main.banglish differs from the last rebuild (or input.txt does and the build depends on it)
+    bool inputChanged = true;   // input.txt differs from the last run
+    string buildKey;            // Compile command and generated code behind the current executable; empty when there is none
+    bool compileSkipped = false;
+    bool runSkipped = false;
+    string reason = "initial build";
+};
+
+// One pass of the driver: front end, reports, build and run. `watch` is null outside --watch.
+int build(const DriverOptions& options, WatchState* watch) {
+    // Read Banglish source; the unit owns the bytes, line index and tokens for every later phase
+    CompilationUnit unit(readSourceFile("main.banglish"));
     
     // Ensure .generated exists
     system("mkdir .generated 2>nul || echo Directory exists");
     
-    // Emit transpiled.cpp and compile to program(.exe)
     string transpiledPath = ".generated/transpiled.cpp";
-    ofstream transpiledFile(transpiledPath);
-    transpiledFile << cppCode;
-    transpiledFile.close();
-    
+    string specializedPath = ".generated/specialized.cpp";
+    string assemblyPath = ".generated/program.s";
+    string cSourcePath = ".generated/program.c";
     string executablePath;
 #ifdef _WIN32
     executablePath = ".generated\\program.exe";
 #else
     executablePath = ".generated/program";
 #endif
+    PgoBuild pgo;
+    string builtCode;       // Compile command and generated code behind the executable, naming it in --bench baselines
+    bool benchRegressed = false;
     
-    string compileCommand = getCompilerCommand(transpiledPath, executablePath);
-    if (system(compileCommand.c_str()) != 0) {
-        cerr << "Error: Compilation of transpiled code failed\n";
-        return 2;
+    // Run compiled program with input.txt -> output.txt
+    auto runProgram = [&] {
+        if (options.profileLines) remove(".generated/line_profile.txt");
+        auto start = chrono::steady_clock::now();
+        int exitCode = system(getRunCommand(executablePath, "input.txt", "output.txt").c_str());
+        if (pgo.built) {
+            double runMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << fixed << setprecision(1) << "PGO: training " << pgo.trainingMs << " ms (instrumented, "
+                 << pgo.trainingRuns << " input" << (pgo.trainingRuns == 1 ? "" : "s")
+                 << (pgo.cached ? ", profile cached" : "") << ") | final " << runMs << " ms (optimized, input.txt)\n";
+            cout.unsetf(ios::floatfield);
+        }
+        if (exitCode != 0) {
+            cerr << "Program exited with code " << exitCode << "\n";
+        }
+        if (options.profileLines) {
+            if (writeLineProfile(unit)) cout << "Line profile written to output_profile.txt\n";
+            else cerr << "Note: no line profile was written (the C++ build did not run to exit)\n";
+        }
+        if (options.bench) benchRegressed = benchmarkProgram(options.benchConfig, executablePath, builtCode);
+    };
+    
+    // Only input.txt changed since the last watch rebuild: the executable is still current, just rerun it
+    if (watch && !watch->sourceChanged && !watch->buildKey.empty() && !options.tiered) {
+        auto start = chrono::steady_clock::now();
+        builtCode = watch->buildKey;
+        runProgram();
+        printPhaseTimes({{"run", chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()}}, watch->reason);
+        return benchRegressed ? 3 : 0;
     }
     
-    // Run compiled program with input.txt -> output.txt
-#ifdef _WIN32
-    string runCommand = "\"" + executablePath + "\" < input.txt > output.txt";
+    // An unchanged source takes the front end's results from the mapped .generated/main.bgc. The reports
+    // beside it were written for the same source, so they are only rendered again if one went missing.
+    auto lexStart = chrono::steady_clock::now();
+    string analysisCachePath = ".generated/main.bgc";
+    bg::AnalysisCache cache;
+    bool reuse = !options.fresh && cache.open(analysisCachePath, unit.source);
+    if (!reuse) remove(analysisCachePath.c_str());
+    auto reportMissing = [](const char* path) { return !filesystem::exists(path); };
+    
+    // Tokens come first: every later phase reads them. --fused also finishes parsing and validation here.
+    ThreadPool pool(options.jobs);
+    ErrorLogger errorLogger("error_log.txt");
+    bg::ValidationReport validation;
+    if (reuse) {
+        // Nothing to lex: the parse, validation and report tasks read the cache
+    } else if (options.fused) {
+        runFusedFrontEnd(unit, errorLogger, validation);
+    } else if (options.jobs > 1) {
+        unit.tokens = lexParallel(unit, pool);
+    } else {
+        Lexer lexer(unit.source);
+        lexer.lex();
+        unit.tokens = std::move(lexer.tokens);
+    }
+    double lexMs = chrono::duration<double, milli>(chrono::steady_clock::now() - lexStart).count();
+    
+    // Remaining phases form a dependency graph. Each writes its own file and console output is only
+    // produced along the parse -> compile -> run chain, so results match a sequential run.
+    TaskGraph graph;
+    Transpiler transpiler;
+    transpiler.useArena = options.useArena;
+    transpiler.splitUnits = options.split;
+    transpiler.lineMap = options.lineMap;
+    transpiler.profileLines = options.profileLines;
+    vector<string> splitSources;
+    string splitNote;       // Printed by the compile task, after the parse task's status line
+    string transpiledCode;
+    bool compiled = false;
+    bool ranTiered = false;
+    
+    // Parse + validate (writes error_log.txt) and report status to console
+    size_t parseTask = graph.add("parse", [&] {
+        size_t errorCount, warningCount;
+        if (reuse) {
+            if (reportMissing("error_log.txt")) cache.diagnostics("error_log.txt").writeLog();
+            errorCount = cache.errorCount();
+            warningCount = cache.warningCount();
+        } else {
+            if (!options.fused) {
+                BanglishParser parser(unit.tokens, errorLogger);
+                parser.parse();
+            }
+            errorLogger.writeLog();
+            errorCount = errorLogger.getErrorCount();
+            warningCount = errorLogger.getWarningCount();
+        }
+        if (errorCount) {
+            cerr << "Compilation failed with " << errorCount << " error(s)";
+            if (warningCount) {
+                cerr << " and " << warningCount << " improvement(s)";
+            }
+            cerr << ". See error_log.txt for details.\n";
+        } else if (warningCount) {
+            cout << "Compilation successful with " << warningCount 
+                 << " improvement(s). See error_log.txt for details.\n";
+        } else {
+            cout << "Compilation successful with no errors or improvements.\n";
+        }
+        cout.flush();
+    });
+    
+    // Write validation and token reports
+    graph.add("validation", [&] {
+        if (reuse) {
+            if (reportMissing("output_validation.txt")) writeValidation(cache.validation());
+            return;
+        }
+        if (!options.fused) {
+            validation.tokenErrors = bg::validateTokens(unit.tokens);
+            validation.lineErrors = bg::validateLines(unit);
+        }
+        writeValidation(validation);
+    });
+    graph.add("tokens", [&] {
+        if (!reuse) writeTokenTable(unit.tokens);
+        else if (reportMissing("output_tokens.txt")) writeTokenTable(cache.tokens());
+    });
+    
+    // Transpile Banglish -> C++ and emit transpiled.cpp
+    size_t transpileTask = graph.add("transpile", [&] {
+        transpiledCode = transpiler.transpile(unit);
+        ofstream transpiledFile(transpiledPath);
+        transpiledFile << transpiledCode;
+        if (options.split > 1) {
+            SplitProgram split = transpiler.split();
+            if (split.units.empty()) {
+                splitNote = split.note;
+                return;
+            }
+            filesystem::remove_all(".generated/split");
+            filesystem::create_directories(".generated/split");
+            ofstream(".generated/split/bg_program.h") << split.header;
+            for (size_t i = 0; i < split.units.size(); ++i) {
+                splitSources.push_back(".generated/split/part" + to_string(i) + ".cpp");
+                ofstream(splitSources.back()) << split.units[i];
+            }
+        }
+    });
+    graph.add("symbols", [&] {
+        if (!reuse) writeSymbolTable(transpiler.sym.all());
+        else if (reportMissing("output_symbol_table.txt")) writeSymbolTable(cache.symbols());
+    }, {transpileTask});
+    
+    // Compile to program(.exe) while the reports above are still being written
+    size_t compileTask = graph.add("compile", [&] {
+        if (!splitNote.empty()) cerr << "Note: --split kept a single translation unit (" << splitNote << ")\n";
+        // --backend=c|x86 lower the program without going through C++; anything they cannot express goes to g++
+        string debugFlags = options.lineMap ? " -g" : "";
+        string cppSource = transpiledPath;
+        auto cppCommand = [&](const string& flags) {
+            return splitSources.empty() ? getCompilerCommand(cppSource, executablePath, "", debugFlags + flags)
+                                        : getSplitCompilerCommand(splitSources, executablePath, debugFlags + flags);
+        };
+        string compileCommand = cppCommand("");
+        string generatedCode = transpiledCode;
+        Program program;
+        bool lowered = false;
+        if (options.backend != "cpp" || options.tiered || options.specialize) {
+            if (reuse) unit.tokens = cache.tokens();
+            try {
+                buildProgram(unit, program);
+                lowered = true;
+            } catch (const LoweringError& e) {
+                cerr << "Note: " << (options.backend != "cpp" ? options.backend + " backend" : string(options.tiered ? "tiered mode" : "--specialize"))
+                     << " skipped (" << e.what() << "), using g++\n";
+            }
+        }
+        if (lowered && options.backend != "cpp") {
+            try {
+                if (options.backend == "c") {
+                    generatedCode = CCodegen().generate(program);
+                    ofstream(cSourcePath) << generatedCode;
+                    string runtime = prepareNativeRuntime();
+                    if (!runtime.empty()) compileCommand = getCompilerCommand(cSourcePath, executablePath, runtime);
+                    else cerr << "Note: native runtime failed to build, using g++\n";
+                } else {
+#if defined(__x86_64__) && defined(__linux__)
+                    generatedCode = X86Codegen().generate(program);
+                    ofstream(assemblyPath) << generatedCode;
+                    string runtime = prepareNativeRuntime();
+                    if (!runtime.empty()) compileCommand = getNativeBuildCommand(assemblyPath, runtime, executablePath);
+                    else cerr << "Note: native runtime failed to build, using g++\n";
 #else
-    string runCommand = "./" + executablePath + " < input.txt > output.txt";
+                    cerr << "Note: native backend needs x86-64 Linux, using g++\n";
 #endif
+                }
+            } catch (const LoweringError& e) {
+                cerr << "Note: " << options.backend << " backend skipped (" << e.what() << "), using g++\n";
+            }
+        }
+        if (lowered && options.specialize) {
+            ifstream inputFile("input.txt", ios::binary);
+            if (options.tiered || compileCommand != cppCommand("")) {
+                cerr << "Note: --specialize needs the g++ build without --tiered, keeping the general program\n";
+            } else if (!inputFile) {
+                cerr << "Note: --specialize needs input.txt, keeping the general program\n";
+            } else {
+                string input((istreambuf_iterator<char>(inputFile)), istreambuf_iterator<char>());
+                Specialization spec = specializeForInput(program, transpiledCode, input);
+                if (!spec.ok) {
+                    cerr << "Note: --specialize kept the general program (" << spec.note << ")\n";
+                } else {
+                    generatedCode = spec.code;
+                    ofstream(specializedPath) << spec.code;
+                    cppSource = specializedPath;
+                    splitSources.clear();
+                    compileCommand = cppCommand("");
+                    cout << fixed << setprecision(1) << "Specialized for input.txt: " << spec.outputBytes
+                         << " bytes of output precomputed in " << spec.evalMs << " ms\n";
+                    cout.unsetf(ios::floatfield);
+                }
+            }
+        }
+        builtCode = compileCommand + "\n" + generatedCode;
+        // .generated/program.key names the code behind the executable, so --tiered can run a current binary at once
+        const string programKeyPath = ".generated/program.key";
+        auto keyBuild = [&](bool built) {
+            if (built) ofstream(programKeyPath) << bg::hexName(bg::fnv1a(builtCode));
+            else remove(programKeyPath.c_str());
+        };
+        if (lowered && options.tiered) {
+            string lastKey;
+            ifstream(programKeyPath) >> lastKey;
+            if (lastKey == bg::hexName(bg::fnv1a(builtCode)) && filesystem::exists(executablePath)) {
+                cout << "Tier: native binary from an earlier build is current, running it\n";
+                compiled = true;
+                return;
+            }
+            keyBuild(false);
+            TierReport tier = runTiered(program, compileCommand, executablePath, "input.txt", "output.txt");
+            if (tier.handled) {
+                ranTiered = true;
+                reportTier(tier);
+                compiled = tier.compiled;
+                keyBuild(compiled);
+                return;
+            }
+            cerr << "Note: tiered mode needs fork(), using the normal build\n";
+        }
+        if (options.pgo) {
+            if (options.tiered || compileCommand != cppCommand("") || compileCommand.rfind("g++", 0) != 0) {
+                cerr << "Note: --pgo needs the g++ build without --tiered, building without a profile\n";
+            } else {
+                vector<string> inputs = pgoTrainingInputs(options.pgoInputs);
+                if (inputs.empty()) cerr << "Note: no training inputs in " << options.pgoInputs << ", building without a profile\n";
+                else {
+                    keyBuild(false);
+                    pgo = buildWithProfile(transpiledCode + "\nsplit=" + to_string(splitSources.size()), inputs, cppCommand, executablePath);
+                    if (!pgo.built) {
+                        cerr << "Error: Compilation of transpiled code failed\n";
+                        return;
+                    }
+                    builtCode += "\nprofile-use";
+                    keyBuild(true);
+                    compiled = true;
+                    return;
+                }
+            }
+        }
+        // In --watch, byte-identical code under the same command needs no g++ (and no rerun unless input.txt changed)
+        const string& buildKey = builtCode;
+        if (watch && !watch->buildKey.empty() && watch->buildKey == buildKey && filesystem::exists(executablePath)) {
+            watch->compileSkipped = true;
+            compiled = true;
+            return;
+        }
+        if (watch) watch->buildKey.clear();
+        keyBuild(false);
+        if (system(compileCommand.c_str()) != 0) {
+            cerr << "Error: Compilation of transpiled code failed\n";
+            return;
+        }
+        if (watch) watch->buildKey = buildKey;
+        keyBuild(true);
+        compiled = true;
+    }, {transpileTask, parseTask});
+    
+    graph.add("run", [&] {
+        if (!compiled) return;
+        if (ranTiered) {
+            if (options.bench) benchRegressed = benchmarkProgram(options.benchConfig, executablePath, builtCode);
+            return;
+        }
+        if (watch && watch->compileSkipped && !watch->inputChanged) {
+            watch->runSkipped = true;
+            return;
+        }
+        runProgram();
+    }, {compileTask});
     
-    int exitCode = system(runCommand.c_str());
-    if (exitCode != 0) {
-        cerr << "Program exited with code " << exitCode << "\n";
+    graph.run(pool);
+    if (!reuse) bg::AnalysisCacheWriter(unit.tokens, errorLogger, validation, transpiler.sym.all()).write(analysisCachePath, unit.source);
+    if (watch) {
+        vector<pair<string, double>> times = graph.timings();
+        times.insert(times.begin(), {"lex", lexMs});
+        for (auto& phase : times) {
+            if ((phase.first == "compile" && watch->compileSkipped) || (phase.first == "run" && watch->runSkipped)) phase.second = -1;
+        }
+        printPhaseTimes(times, watch->reason);
     }
     
     // Done
+    if (!compiled) return 2;
+    return benchRegressed ? 3 : 0;
+}
+
+// Contents of a file, or nullopt while it is missing (an editor may be mid-way through replacing it)
+optional<string> readIfPresent(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file) return nullopt;
+    return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+}
+
+// --watch: builds once, then waits for changes to main.banglish or input.txt. Bursts of events (an editor
+// saving through a temporary file, a script writing both files) are debounced into one rebuild, and what
+// actually changed is decided by comparing contents, not by which events arrived.
+int watchSources(const DriverOptions& options) {
+    const int DEBOUNCE_MS = 150;
+    WatchState state;
+    optional<string> source = readIfPresent("main.banglish"), input = readIfPresent("input.txt");
+    build(options, &state);
+#ifdef __linux__
+    int fd = inotify_init1(IN_CLOEXEC);
+    // The directory is watched rather than the files so replacing them by rename is seen too
+    if (fd < 0 || inotify_add_watch(fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM) < 0) {
+        cerr << "Error: cannot watch the current directory\n";
+        return 1;
+    }
+    auto relevantEvents = [&](int timeoutMs) {
+        bool relevant = false;
+        alignas(inotify_event) char buffer[1 << 14];
+        pollfd waiter{fd, POLLIN, 0};
+        while (poll(&waiter, 1, timeoutMs) > 0) {
+            ssize_t n = read(fd, buffer, sizeof buffer);
+            if (n <= 0) break;
+            for (char* at = buffer; at < buffer + n; at += sizeof(inotify_event) + ((inotify_event*)at)->len) {
+                inotify_event* event = (inotify_event*)at;
+                string name = event->len ? event->name : "";
+                if (name == "main.banglish" || name == "input.txt") relevant = true;
+            }
+            if (timeoutMs < 0) break;
+        }
+        return relevant;
+    };
+#endif
+    cout << "Watching main.banglish and input.txt (Ctrl+C to stop)" << endl;
+    while (true) {
+#ifdef __linux__
+        if (!relevantEvents(-1)) continue;
+        while (relevantEvents(DEBOUNCE_MS)) {}
+#else
+        this_thread::sleep_for(chrono::milliseconds(DEBOUNCE_MS));
+#endif
+        optional<string> newSource = readIfPresent("main.banglish"), newInput = readIfPresent("input.txt");
+        if (!newSource) continue;
+        state.sourceChanged = newSource != source;
+        state.inputChanged = newInput != input;
+        if (!state.sourceChanged && !state.inputChanged) continue;
+        // Specialized and profile-guided builds are trained on input.txt, so for them it is a build input too
+        if (state.inputChanged && (options.specialize || options.pgo)) state.sourceChanged = true;
+        state.reason = newSource == source ? "input.txt changed"
+                     : newInput == input ? "main.banglish changed" : "main.banglish and input.txt changed";
+        source = newSource;
+        input = newInput;
+        state.compileSkipped = state.runSkipped = false;
+        build(options, &state);
+        cout.flush();
+    }
+}
+
+// One REPL input's phases as "(lex 2.1 us | check 0.8 us | parse 1.9 us | run 0.4 us | total 5.2 us)"
+void printReplTiming(const ReplSession::Timing& t) {
+    cout << fixed << setprecision(1) << "(lex " << t.lexUs << " us | check " << t.checkUs << " us | parse " << t.parseUs
+         << " us | run " << t.runUs << " us | total " << t.totalUs() << " us)\n";
+    cout.unsetf(ios::floatfield);
+}
+
+// --repl: reads statements from stdin and runs each as soon as it is complete. Lines starting with ':' are
+// commands; prompts are only shown on a terminal, so a script can be piped through it.
+int runRepl() {
+#ifdef _WIN32
+    bool interactive = _isatty(0);
+#else
+    bool interactive = isatty(0);
+#endif
+    unique_ptr<ReplSession> session(new ReplSession(cin));
+    bool showTimes = false;
+    string pending, line;
+    auto prompt = [&] {
+        if (interactive) cout << (pending.empty() ? "banglish> " : "      ... ") << flush;
+    };
+    auto evaluate = [&] {
+        ReplSession::Result result = session->evaluate(pending);
+        pending.clear();
+        cout << result.output;
+        if (!result.output.empty() && result.output.back() != '\n') cout << "\n";
+        for (const string& error : result.errors) cout << error << "\n";
+        if (result.exited) cout << "ferot dao " << result.exitCode << "\n";
+        if (showTimes) printReplTiming(result.timing);
+        cout.flush();
+    };
+    if (interactive) cout << "Banglish REPL: statements run as you enter them, :help lists commands\n";
+    prompt();
+    while (getline(cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        bool blank = line.find_first_not_of(" \t") == string::npos;
+        if (pending.empty() && !blank && line[0] == ':') {
+            string command = line.substr(1, line.find_last_not_of(" \t"));
+            if (command == "q" || command == "quit") return 0;
+            if (command == "s" || command == "symbols") {
+                writeSymbolTable(session->symbols(), cout);
+            } else if (command == "timing") {
+                cout << fixed << setprecision(1) << padRight("#", 6) << setw(10) << "lex us" << setw(10) << "check us"
+                     << setw(10) << "parse us" << setw(10) << "run us" << setw(10) << "total us" << "  input\n";
+                size_t first = session->history().size() > 20 ? session->history().size() - 20 : 0;
+                for (size_t k = first; k < session->history().size(); ++k) {
+                    const ReplSession::Timing& t = session->history()[k];
+                    cout << padRight(to_string(k + 1), 6) << setw(10) << t.lexUs << setw(10) << t.checkUs << setw(10) << t.parseUs
+                         << setw(10) << t.runUs << setw(10) << t.totalUs() << "  " << t.source << "\n";
+                }
+                cout.unsetf(ios::floatfield);
+            } else if (command == "time") {
+                showTimes = !showTimes;
+                cout << "Per-input timing " << (showTimes ? "on" : "off") << "\n";
+            } else if (command == "reset") {
+                session.reset(new ReplSession(cin));
+                cout << "All variables cleared\n";
+            } else {
+                cout << ":symbols (:s)  variables with their current values\n"
+                     << ":time          print lex/check/parse/run times after every input (toggle)\n"
+                     << ":timing        times of the last 20 inputs\n"
+                     << ":reset         forget every variable\n"
+                     << ":quit (:q)     leave (so does end of input)\n"
+                     << "Blocks run once their brackets close; a jodi runs after a blank line, so a nahoy may follow.\n";
+            }
+            prompt();
+            continue;
+        }
+        if (blank && pending.empty()) {
+            prompt();
+            continue;
+        }
+        if (!blank) pending += line + "\n";
+        if (ReplSession::complete(pending, blank)) evaluate();
+        prompt();
+    }
+    if (!pending.empty()) evaluate();
     return 0;
 }
+
+int main(int argc, char** argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+    DriverOptions options = parseOptions(argc, argv);
+    if (options.repl) return runRepl();
+    if (options.watch) return watchSources(options);
+    return build(options, nullptr);
+}